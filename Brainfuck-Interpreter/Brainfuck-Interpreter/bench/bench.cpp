@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stack>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include "interpreter.h"
+#include "utils.h"
+
+//Benchmark of the execution modes of the interpreter on a corpus of programs
+//Each 'name.b' of the corpus is run with 'name.in' as input when it exists and
+//its output is checked against the golden file 'name.out'
+
+const std::string HELP = {
+	"bf_bench [-h] [-t <seconds>] [-m <modes>] <corpus directory>\n"\
+	"\n"\
+	"-h\tDisplay this help message\n"\
+	"-t <seconds> minimum time spent on each program in each mode, default is 0.5\n"\
+	"-m <modes> comma separated list of the modes to run among\n"\
+	"\tconsole, none, all, fixed and jit, default is all of them\n"
+};
+
+struct Case {
+	std::string name;
+	std::string code;
+	std::string input;
+	std::string expected;
+	//Number of brainfuck instructions executed by the program
+	unsigned long long operations;
+};
+
+struct Mode {
+	std::string name;
+	//The console runs the code char by char and shares its input with the program
+	bool console;
+	std::function<void(BFInterpreter&)> setup;
+};
+
+const std::vector<Mode> MODES = {
+	{ "console", true, [](BFInterpreter&) {} },
+	{ "none", false, [](BFInterpreter& i) { i.set_optimization(Optimization::none); } },
+	{ "all", false, [](BFInterpreter& i) { i.set_optimization(Optimization::all); } },
+	{ "fixed", false, [](BFInterpreter& i) { i.set_tape(TapeKind::fixed); } },
+	{ "jit", false, [](BFInterpreter& i) { i.set_jit(true); } }
+};
+
+bool read_file(std::string const& path, std::string& content) {
+	std::ifstream f(path, std::ios::binary);
+	if (f.fail()) return false;
+	std::ostringstream ss;
+	ss << f.rdbuf();
+	content = ss.str();
+	return true;
+}
+
+//Run the code the simplest way to count the instructions it executes
+unsigned long long count_operations(std::string const& code, std::string const& input) {
+	std::vector<size_t> jump(code.size());
+	std::stack<size_t> open_loop;
+	for (size_t i(0); i != code.size(); ++i) {
+		if (code[i] == '[') open_loop.push(i);
+		else if (code[i] == ']') {
+			if (open_loop.empty()) throw std::runtime_error("unbalanced brackets");
+			jump[i] = open_loop.top();
+			jump[open_loop.top()] = i;
+			open_loop.pop();
+		}
+	}
+	if (!open_loop.empty()) throw std::runtime_error("unbalanced brackets");
+
+	unsigned long long operations(0);
+	std::vector<unsigned char> tape(1, 0);
+	size_t cell(0), read(0);
+	for (size_t i(0); i != code.size(); ++i) {
+		switch (code[i]) {
+		case '+': ++tape[cell]; break;
+		case '-': --tape[cell]; break;
+		case '>': if (++cell == tape.size()) tape.push_back(0); break;
+		case '<':
+			if (cell == 0) throw std::runtime_error("the pointer leaves the tape");
+			--cell;
+			break;
+		case '.': break;
+		case ',': if (read != input.size()) tape[cell] = input[read++]; break;
+		case '[': if (tape[cell] == 0) i = jump[i]; break;
+		case ']': if (tape[cell] != 0) i = jump[i]; break;
+		default: continue;
+		}
+		++operations;
+	}
+	return operations;
+}
+
+bool load_case(std::string const& directory, std::string const& name, Case& c) {
+	std::string source;
+	if (!read_file(directory + '/' + name + ".b", source)) return false;
+	if (!read_file(directory + '/' + name + ".out", c.expected)) {
+		std::cerr << name << ": missing golden file '" << name << ".out'\n";
+		return false;
+	}
+	read_file(directory + '/' + name + ".in", c.input);
+	c.name = name;
+	c.code.clear();
+	for (char ch : source)
+		if (BFInterpreter::BF_CHAR.count(ch)) c.code += ch;
+	c.operations = count_operations(c.code, c.input);
+	return true;
+}
+
+std::vector<std::string> list_programs(std::string const& directory) {
+	DIR* dir = opendir(directory.c_str());
+	if (!dir) throw std::invalid_argument("unable to open the corpus directory '" + directory + "'\n");
+	std::vector<std::string> names;
+	while (dirent* entry = readdir(dir)) {
+		std::string file(entry->d_name);
+		if (file.size() > 2 && file.compare(file.size() - 2, 2, ".b") == 0)
+			names.push_back(file.substr(0, file.size() - 2));
+	}
+	closedir(dir);
+	std::sort(names.begin(), names.end());
+	return names;
+}
+
+//The console echoes nothing but writes a new line after each output and its prompts
+std::string console_output(std::string const& output) {
+	std::string result(":::");
+	for (char c : output) {
+		result += c;
+		result += '\n';
+	}
+	return result + ":::Quiting brainfuck console\n";
+}
+
+//Run the case once in the mode, return the time taken by the run in seconds
+double run_once(Case const& c, Mode const& mode, std::string& output) {
+	std::istringstream in(mode.console ? c.code + "\nexit\n" : c.input);
+	std::ostringstream out;
+	BFInterpreter interpreter(mode.console ? std::string() : c.code, out, in);
+	if (mode.console) interpreter.set_console();
+	else interpreter.set_file();
+	mode.setup(interpreter);
+	auto start = std::chrono::steady_clock::now();
+	interpreter.run();
+	std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+	output = out.str();
+	return time.count();
+}
+
+//Return false when the output of the program is wrong
+bool bench(Case const& c, Mode const& mode, double const& min_time) {
+	std::cout << std::left << std::setw(12) << c.name << std::setw(10) << mode.name << std::right;
+	if (mode.console && !c.input.empty()) {
+		std::cout << "  skipped, the console can't give it its input\n";
+		return true;
+	}
+	std::string const expected = mode.console ? console_output(c.expected) : c.expected;
+	std::string output;
+	double total(0);
+	unsigned int runs(0);
+	try {
+		do {
+			total += run_once(c, mode, output);
+			++runs;
+			if (output != expected) {
+				std::cout << "  wrong output\n";
+				return false;
+			}
+		} while (total < min_time && runs < 1000);
+	}
+	catch (std::exception const& e) {
+		std::cout << "  error: " << e.what();
+		return false;
+	}
+	double const seconds = total / runs;
+	std::cout << std::setw(6) << runs
+		<< std::setw(14) << c.operations
+		<< std::fixed << std::setprecision(3)
+		<< std::setw(10) << seconds * 1e9 / c.operations
+		<< std::setprecision(1)
+		<< std::setw(12) << c.operations / seconds / 1e6
+		<< "  ok\n";
+	return true;
+}
+
+int main(int argc, char* argv[]) {
+	double min_time(0.5);
+	std::vector<Mode> modes(MODES);
+	std::string directory;
+	try {
+		for (int i(1); i != argc; ++i) {
+			if (*argv[i] != '-') {
+				directory = argv[i];
+				continue;
+			}
+			switch (*(argv[i] + 1)) {
+			case 'h':
+				std::cout << HELP;
+				return 0;
+			case 't':
+				if (argc == ++i) throw std::invalid_argument("missing time after '-t'\n");
+				if (!(std::stringstream(argv[i]) >> min_time) || min_time < 0)
+					throw std::invalid_argument("'-t' takes a positive number of seconds\n");
+				break;
+			case 'm': {
+				if (argc == ++i) throw std::invalid_argument("missing mode list after '-m'\n");
+				std::vector<std::string> names;
+				split(names, argv[i], ',');
+				modes.clear();
+				for (std::string const& name : names) {
+					auto it = std::find_if(MODES.begin(), MODES.end(), [&](Mode const& m) { return m.name == name; });
+					if (it == MODES.end()) throw std::invalid_argument("unknown mode '" + name + "'\n");
+					modes.push_back(*it);
+				}
+				break;
+			}
+			default:
+				throw std::invalid_argument("Argument unknown\n");
+			}
+		}
+		if (directory.empty()) throw std::invalid_argument("missing corpus directory\n");
+
+		std::vector<Case> cases;
+		for (std::string const& name : list_programs(directory)) {
+			Case c;
+			if (load_case(directory, name, c)) cases.push_back(c);
+		}
+
+		std::cout << std::left << std::setw(12) << "program" << std::setw(10) << "mode" << std::right
+			<< std::setw(6) << "runs" << std::setw(14) << "instructions"
+			<< std::setw(10) << "ns/op" << std::setw(12) << "Minstr/s" << '\n';
+		bool correct(true);
+		for (Case const& c : cases)
+			for (Mode const& mode : modes)
+				correct = bench(c, mode, min_time) && correct;
+		return correct ? 0 : 1;
+	}
+	catch (std::invalid_argument const& e) {
+		std::cerr << e.what() << HELP;
+	}
+	catch (std::exception const& e) {
+		std::cerr << e.what() << '\n';
+	}
+	return 2;
+}
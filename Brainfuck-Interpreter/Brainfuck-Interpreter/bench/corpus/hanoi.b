@@ -0,0 +1,36 @@
+Towers of Hanoi with 16 disks moved from peg A to peg C
+The moves are counted in binary and the disk to move is the lowest bit set
+Prints the final peg of each disk
+>>>>>>>>+>>>+>>>>>+>>>++>>>>>+>>>+>>>>>+>>>++>>>>>+>>>+>>>>>+>>>++>>>>>+
+>>>+>>>>>+>>>++>>>>>+>>>+>>>>>+>>>++>>>>>+>>>+>>>>>+>>>++>>>>>+>>>+>>>>>
++>>>++>>>>>+>>>+>>>>>+>>>++>>>>>+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<+[>>>>>>>>[->>>>>>>>]+>>[->+>+<<]>>[-<<+>>]<[<[-
+>>+>+<<<]>>>[-<<<+>>>]<[-<<<+[->>>>+>+<<<<<]>>>>>[-<<<<<+>>>>>]<--->+<[>
+[-]<[-]]>[<<<<<[-]>>>>>-]<<]<[-]]<<<<[<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>[<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<[-]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>[-]]<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<
+<<<<<<<<<<<<<<<<<<<<<<<<]>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+>>>>>>>>>>++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++.<<<<<<<<++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++.<<<<<<<<<++++++++++.
@@ -0,0 +1,9 @@
+Four nested counted loops updating several cells in the innermost one
+Prints the final value of the updated cells
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++[->++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++[->++++++++++++++++++++++++++++++++++
+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
++++++++++++++++++++++++++++++++++++++++++++++[->+++>------->+++++++++++<
+<<]>>>>+<<<<<]>>>>>>+<<<<<<<]>>>.>.>.>.>.
@@ -0,0 +1,28 @@
+Rotates the letters of its input by 13 places
+A copy of each byte is decremented in lockstep with a counter to compare it with the bounds of the letters
+>>>+<<<,[[->+>>>>+<<<<<]>>>>>[-<<<<<+>>>>>]<<<<[>]>[<<->]<[>]>[<<->]<[>]
+>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->
+]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>
+[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]
+<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[
+<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<
+[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<
+<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[
+>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<
+->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>
+]>[<<->]<[>]>[<<->]<[>]>[<<->]+>-<<[>>]>[>>>>+<<]<<->+<<[>]>[<<->]<[>]>[
+<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<
+[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]+>-<<[>>]>[>>>>>+<
+<<]<<->+<<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<
+->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>
+]>[<<->]+>-<<[>>]>[>>>>>>+<<<<]<<->+<<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[
+>]>[<<->]<[>]>[<<->]<[>]>[<<->]+>-<<[>>]>[>>>>>>>+<<<<<]<<->+<<[>]>[<<->
+]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>
+[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]+>-<<[>>]>[
+>>>>>>>>+<<<<<<]<<->+<<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[
+<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<[>]>[<<->]<
+[>]>[<<->]<[>]>[<<->]+>-<<[>>]>[>>>>>>>>>+<<<<<<<]<<->+<<[>]>[<<->]<[-]>
+>>>>[-<<<<<<------------->>>>>>]>[-<<<<<<<++++++++++++++++++++++++++>>>>
+>>>]>[-<<<<<<<<------------->>>>>>>>]>[-<<<<<<<<<------------->>>>>>>>>]
+>[-<<<<<<<<<<++++++++++++++++++++++++++>>>>>>>>>>]>[-<<<<<<<<<<<--------
+----->>>>>>>>>>>]<<<<<<<<<<<.[-],]
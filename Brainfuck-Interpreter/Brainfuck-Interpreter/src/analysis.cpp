@@ -0,0 +1,122 @@
+#include "analysis.h"
+
+#include <algorithm>
+
+static void use(BFBounds& bounds, long const& cell) throw() {
+	bounds.lowest = std::min(bounds.lowest, cell);
+	bounds.highest = std::max(bounds.highest, cell);
+}
+
+BFAnalysis::BFAnalysis(std::vector<Instruction> const& code) :
+	m_loops(code.size(), BFBounds{ false, 0, 0, 0 }) {
+	//Bounds of the code read so far in each open loop, the first one is the whole program
+	std::vector<BFBounds> open(1, BFBounds{ true, 0, 0, 0 });
+	for (Instruction const& action : code) {
+		switch (action.op) {
+		case OpCode::MOVE:
+			open.back().shift += action.arg;
+			use(open.back(), open.back().shift);
+			break;
+		case OpCode::SCAN:
+			//The zero cell may be anywhere
+			open.back().bounded = false;
+			break;
+		case OpCode::OPEN:
+			open.push_back(BFBounds{ true, 0, 0, 0 });
+			break;
+		case OpCode::CLOSE: {
+			BFBounds loop = open.back();
+			open.pop_back();
+			loop.bounded = loop.bounded && loop.shift == 0;
+			m_loops[action.arg] = loop;
+			BFBounds& outer = open.back();
+			if (!loop.bounded) outer.bounded = false;
+			else {
+				use(outer, outer.shift + loop.lowest);
+				use(outer, outer.shift + loop.highest);
+			}
+			break;
+		}
+		case OpCode::RESERVE:
+			break;
+		default:
+			//The other instructions use the cell at their offset
+			use(open.back(), open.back().shift + action.offset);
+			break;
+		}
+	}
+	m_program = open.front();
+	//A loop still open may go anywhere
+	if (open.size() != 1) m_program.bounded = false;
+}
+
+BFBounds const& BFAnalysis::loop(size_t const& open) const throw() {
+	return m_loops[open];
+}
+
+BFBounds const& BFAnalysis::program() const throw() {
+	return m_program;
+}
+
+//The group is kept when it has several loops, a new one is started
+static void close_group(std::vector<BFLoopGroup>& groups, BFLoopGroup& group) {
+	if (group.loops.size() > 1) groups.push_back(group);
+	group.loops.clear();
+}
+
+std::vector<BFLoopGroup> BFAnalysis::independent_loops(std::vector<Instruction> const& code) const {
+	std::vector<BFLoopGroup> groups;
+	BFLoopGroup group = { 0, 0, { true, 0, 0, 0 }, {} };
+	//Pointer from the '[' of the first loop of the group
+	long shift(0);
+	size_t i(0);
+	while (i != code.size()) {
+		if (code[i].op == OpCode::MOVE) {
+			shift += code[i].arg;
+			++i;
+			continue;
+		}
+		size_t const open = code[i].op == OpCode::RESERVE ? i + 1 : i;
+		if (code[open].op != OpCode::OPEN) {
+			close_group(groups, group);
+			++i;
+			continue;
+		}
+		size_t const close = code[open].arg;
+		BFBounds const& loop = m_loops[open];
+		bool independent = loop.bounded;
+		for (size_t j(open); independent && j != close; ++j)
+			if (code[j].op == OpCode::INPUT || code[j].op == OpCode::OUTPUT) independent = false;
+		if (!independent) {
+			close_group(groups, group);
+			i = close + 1;
+			continue;
+		}
+		//Cells of the loop from the '[' of the first loop
+		long const lowest = shift + loop.lowest;
+		long const highest = shift + loop.highest;
+		bool disjoint = !group.loops.empty();
+		for (size_t j(0); disjoint && j != group.loops.size(); ++j) {
+			BFRegion const& other = group.loops[j];
+			BFBounds const& bounds = m_loops[code[other.first].op == OpCode::RESERVE ? other.first + 1 : other.first];
+			if (lowest <= other.shift + bounds.highest && other.shift + bounds.lowest <= highest) disjoint = false;
+		}
+		if (!disjoint) {
+			close_group(groups, group);
+			shift = 0;
+			group.begin = i;
+			group.bounds = { true, loop.lowest, loop.highest, 0 };
+			group.loops.push_back({ i, close, 0 });
+		}
+		else {
+			group.bounds.lowest = std::min(group.bounds.lowest, lowest);
+			group.bounds.highest = std::max(group.bounds.highest, highest);
+			group.bounds.shift = shift;
+			group.loops.push_back({ i, close, shift });
+		}
+		group.end = close + 1;
+		i = close + 1;
+	}
+	close_group(groups, group);
+	return groups;
+}
@@ -1,14 +1,31 @@
 #include "args.h"
 
-#include <fstream>
+#include <map>
+#include <sstream>
+#include <vector>
 #include "interpreter.h"
+#include "utils.h"
 
 //Enum class use for bitflag to identify which args has been used
 enum class Args {
 	F = 0x01,
 	C = 0x02,
 	B = 0x04,
-	H = 0x08
+	H = 0x08,
+	O = 0x10,
+	J = 0x20,
+	T = 0x40,
+	M = 0x80,
+	W = 0x100,
+	I = 0x200,
+	L = 0x400,
+	P = 0x800,
+	X = 0x1000,
+	R = 0x2000,
+	K = 0x4000,
+	N = 0x8000,
+	Q = 0x10000,
+	S = 0x20000
 };
 
 Args operator| (Args const& a, Args const& b) throw() {
@@ -20,25 +37,109 @@ int operator& (Args const& a, Args const& b) throw() {
 }
 
 const std::string HELP = {
-	"BFInterpreter [-h] [-f <file path> | -c | -b <code>]\n"\
+	"BFInterpreter [-h] [-f <file path> | -c | -b <code>] [-O <optimizations>] [-j] [-o <output file>]\n"\
+	"\t[-t <tape> [-s <cells>] [-n]] [-w <bits>] [-i] [-l <list file>] [-d <delimiter>] [-p <threads>] [-k]\n"\
+	"\t[--profile <report file>] [--max-instructions <count>] [--timeout <seconds>]\n"\
+	"\t[--checkpoint <file> [--checkpoint-every <seconds>]] [--resume <file>] [--cache <directory>]\n"\
+	"\t[--parallel] [--metrics <file>]\n"\
 	"\n"\
 	"-h\tDisplay this help message\n"\
 	"\n"\
 	"-f <file path> read brainfuck from a file\n"\
 	"-c run the interpreter in console mode\n"\
-	"-b <code> run the as braifuck code the string pass as code\n"
+	"-b <code> run the as braifuck code the string pass as code\n"\
+	"-O <optimizations> comma separated list of the optimizations to use among\n"\
+	"\tfold, clear, scan, mul, bounds, offsets, prefix, all and none, default is all,\n"\
+	"\t'prefix' runs the start of the code that reads no input only once, the inputs of a\n"\
+	"\tbatch and the runs of a cached code start from the state it leaves\n"\
+	"-j compile the code to native code before running it, when available\n"\
+	"-o <output file> write the code as C, or as x86-64 assembly if the file ends with '.s',\n"\
+	"\tinstead of running it\n"\
+	"-t <tape> how the cells are stored: 'vector' grows with the pointer (default),\n"\
+	"\t'fixed' is allocated at start, 'mmap' reserves a large region used on demand and\n"\
+	"\t'paged' allocates pages of cells when they are first used, the pointer leaving a\n"\
+	"\t'fixed' or 'mmap' tape is an error\n"\
+	"-s <cells> number of cells of a 'fixed' or 'mmap' tape\n"\
+	"-n let the pointer go left of the first cell of a 'paged' tape, on negative cells\n"\
+	"-w <bits> width of the cells, 8 (default), 16 or 32 bits, the cells wrap around\n"\
+	"\tand '.' writes the lowest byte\n"\
+	"-i write each byte of the output right away instead of buffering it\n"\
+	"\n"\
+	"The following options run the code once for each input, on several threads,\n"\
+	"each output is written followed by the delimiter:\n"\
+	"-l <list file> file listing the input files, one by line\n"\
+	"-d <delimiter> character separating the inputs read from the standard input when\n"\
+	"\tthere is no '-l', and written after each output, '\\n' (default), '\\t', '\\0' or any character\n"\
+	"-p <threads> number of threads, default is one by core\n"\
+	"-k write each output as soon as it is ready, after its input file or input number and\n"\
+	"\ta tab, instead of writing them in the order of the inputs\n"\
+	"\n"\
+	"--profile <report file> count the instructions run, by instruction and by loop, and\n"\
+	"\twrite them sorted in the report file, the loops are also written as folded stacks\n"\
+	"\tfor flamegraph.pl in the report file followed by '.folded', the code is not compiled\n"\
+	"\tto native code\n"\
+	"--max-instructions <count> stop the program once it has run about this many instructions,\n"\
+	"\tthey are counted at the end of each iteration of a loop\n"\
+	"--timeout <seconds> stop the program once it has run for this long\n"\
+	"\tA stopped program keeps what it wrote, the pointer position is reported on the error\n"\
+	"\toutput and the exit status is 3\n"\
+	"--checkpoint <file> save the state of the program in the file when it gets SIGTERM, which\n"\
+	"\tstops it, the code is not compiled to native code\n"\
+	"--checkpoint-every <seconds> also save the state of the program this often\n"\
+	"--resume <file> continue the program saved in the file, the program must be given the\n"\
+	"\tsame input and its output goes on after what it already wrote\n"\
+	"--cache <directory> keep the compiled code in the directory, the next runs of the same\n"\
+	"\tcode with the same optimizations read it instead of compiling the code again\n"\
+	"--parallel run on several threads the outermost loops following each other that read and\n"\
+	"\twrite nothing and are proved to use different cells, experimental, only on a 'vector'\n"\
+	"\ttape and without limits, the code is not compiled to native code\n"\
+	"--metrics <file> write in the file as JSON the compiled instructions run, counted like\n"\
+	"\t'--profile' does, the loop iterations, the bytes read and written, the cells of the tape\n"\
+	"\treached and the time spent loading, compiling and running the code, at the end of the\n"\
+	"\trun and each time the program gets SIGUSR1, the code is not compiled to native code\n"
 };
 
-void load_file(std::string& code, char* const& path) {
-	std::ifstream f(path);
-	if (f.fail()) throw std::invalid_argument("Invalid path or an error have occured when oppening the file");
-	char read_char;
-	while (f.get(read_char))
-		if (BFInterpreter::is_valid_brainfuck_char(read_char)) code += read_char;
+const std::map<std::string, TapeKind> NAME_TO_TAPE = { { "vector", TapeKind::vector },
+														{ "fixed", TapeKind::fixed },
+														{ "mmap", TapeKind::mmap },
+														{ "paged", TapeKind::paged } };
+
+const std::map<std::string, Optimization> NAME_TO_OPTIMIZATION = { { "none", Optimization::none },
+																	{ "fold", Optimization::fold },
+																	{ "clear", Optimization::clear },
+																	{ "scan", Optimization::scan },
+																	{ "mul", Optimization::multiply },
+																	{ "bounds", Optimization::bounds },
+																	{ "offsets", Optimization::offsets },
+																	{ "prefix", Optimization::prefix },
+																	{ "all", Optimization::all } };
+
+Optimization parse_optimization(std::string const& list) {
+	std::vector<std::string> names;
+	split(names, list, ',');
+	Optimization optimization(Optimization::none);
+	for (std::string const& name : names) {
+		auto it = NAME_TO_OPTIMIZATION.find(name);
+		if (it == NAME_TO_OPTIMIZATION.end()) throw std::invalid_argument("unknown optimization '" + name + "'\n");
+		optimization = optimization | it->second;
+	}
+	return optimization;
+}
+
+char parse_delimiter(std::string const& delimiter) {
+	if (delimiter.size() == 1) return delimiter[0];
+	if (delimiter == "\\n") return '\n';
+	if (delimiter == "\\t") return '\t';
+	if (delimiter == "\\0") return '\0';
+	throw std::invalid_argument("'-d' takes a single character, '\\n', '\\t' or '\\0'\n");
 }
 
 void handle_args(BFInterpreter& interpreter, int argc, char* argv[]) {
-	std::string code;
+	size_t tape_size(0);
+	BatchOptions batch;
+	BFLimits limits;
+	std::string checkpoint;
+	double checkpoint_period(0);
 	//Set the args flag to no args entered
 	Args args_set(static_cast<Args>(0));
 	//If no argument are used the Interpreter is put in console mode
@@ -58,12 +159,19 @@ void handle_args(BFInterpreter& interpreter, int argc, char* argv[]) {
 					if (argc == ++i) throw std::invalid_argument("missing filename after '-f'\n");
 					args_set = args_set | Args::F;
 					interpreter.set_file();
-					load_file(code, argv[i]);
-					interpreter.set_code(code);
+					interpreter.set_source(argv[i]);
 					break;
 				case 'c':
 					if (args_set & Args::F) throw std::invalid_argument("'-f' and '-c' are unusable together\n");
+					if (args_set & Args::T) throw std::invalid_argument("'-o' and '-c' are unusable together\n");
 					if (args_set & Args::B) throw std::invalid_argument("'-c' and '-b' are unusable together\n");
+					if (args_set & Args::L) throw std::invalid_argument("'-c' and the batch options are unusable together\n");
+					if (args_set & Args::P) throw std::invalid_argument("'-c' and '--profile' are unusable together\n");
+					if (args_set & Args::X) throw std::invalid_argument("'-c' and the limits are unusable together\n");
+					if (args_set & Args::R) throw std::invalid_argument("'-c' and the checkpoints are unusable together\n");
+					if (args_set & Args::K) throw std::invalid_argument("'-c' and '--cache' are unusable together\n");
+					if (args_set & Args::Q) throw std::invalid_argument("'-c' and '--parallel' are unusable together\n");
+					if (args_set & Args::S) throw std::invalid_argument("'-c' and '--metrics' are unusable together\n");
 					args_set = args_set | Args::C;
 					interpreter.set_console();
 					break;
@@ -75,6 +183,149 @@ void handle_args(BFInterpreter& interpreter, int argc, char* argv[]) {
 					interpreter.set_file();
 					interpreter.set_code(argv[i]);
 					break;
+				case 'O':
+					if (argc == ++i) throw std::invalid_argument("missing optimization list after '-O'\n");
+					args_set = args_set | Args::O;
+					interpreter.set_optimization(parse_optimization(argv[i]));
+					break;
+				case 'j':
+					args_set = args_set | Args::J;
+					interpreter.set_jit(true);
+					break;
+				case 'o':
+					if (args_set & Args::C) throw std::invalid_argument("'-o' and '-c' are unusable together\n");
+					if (args_set & Args::L) throw std::invalid_argument("'-o' and the batch options are unusable together\n");
+					if (args_set & Args::P) throw std::invalid_argument("'-o' and '--profile' are unusable together\n");
+					if (args_set & Args::X) throw std::invalid_argument("'-o' and the limits are unusable together\n");
+					if (args_set & Args::R) throw std::invalid_argument("'-o' and the checkpoints are unusable together\n");
+					if (args_set & Args::S) throw std::invalid_argument("'-o' and '--metrics' are unusable together\n");
+					if (argc == ++i) throw std::invalid_argument("missing filename after '-o'\n");
+					args_set = args_set | Args::T;
+					interpreter.set_translation(argv[i]);
+					break;
+				case 't': {
+					if (argc == ++i) throw std::invalid_argument("missing tape after '-t'\n");
+					auto it = NAME_TO_TAPE.find(argv[i]);
+					if (it == NAME_TO_TAPE.end()) throw std::invalid_argument("unknown tape '" + std::string(argv[i]) + "'\n");
+					args_set = args_set | Args::M;
+					interpreter.set_tape(it->second, tape_size);
+					break;
+				}
+				case 's':
+					if (argc == ++i) throw std::invalid_argument("missing number of cells after '-s'\n");
+					if (!(std::stringstream(argv[i]) >> tape_size) || tape_size == 0)
+						throw std::invalid_argument("'-s' takes a positive integer\n");
+					interpreter.set_tape(interpreter.tape_kind(), tape_size);
+					break;
+				case 'n':
+					if (args_set & Args::R) throw std::invalid_argument("'-n' and the checkpoints are unusable together\n");
+					args_set = args_set | Args::N;
+					interpreter.set_negative_cells(true);
+					break;
+				case 'i':
+					args_set = args_set | Args::I;
+					interpreter.set_interactive(true);
+					break;
+				case 'w': {
+					if (argc == ++i) throw std::invalid_argument("missing width after '-w'\n");
+					unsigned int bits(0);
+					if (!(std::stringstream(argv[i]) >> bits)) throw std::invalid_argument("'-w' takes 8, 16 or 32\n");
+					args_set = args_set | Args::W;
+					interpreter.set_cell_bits(bits);
+					break;
+				}
+				case 'l':
+				case 'd':
+				case 'p':
+				case 'k': {
+					if (args_set & Args::C) throw std::invalid_argument("'-c' and the batch options are unusable together\n");
+					if (args_set & Args::T) throw std::invalid_argument("'-o' and the batch options are unusable together\n");
+					if (args_set & Args::P) throw std::invalid_argument("'--profile' and the batch options are unusable together\n");
+					if (args_set & Args::R) throw std::invalid_argument("The checkpoints and the batch options are unusable together\n");
+					if (args_set & Args::S) throw std::invalid_argument("'--metrics' and the batch options are unusable together\n");
+					char const option = *(argv[i] + 1);
+					if (option != 'k' && argc == ++i)
+						throw std::invalid_argument("missing value after '-" + std::string(1, option) + "'\n");
+					if (option == 'l') batch.list = argv[i];
+					else if (option == 'd') batch.delimiter = parse_delimiter(argv[i]);
+					else if (option == 'p' && (!(std::stringstream(argv[i]) >> batch.threads) || batch.threads == 0))
+						throw std::invalid_argument("'-p' takes a positive integer\n");
+					else if (option == 'k') batch.keyed = true;
+					args_set = args_set | Args::L;
+					interpreter.set_batch(batch);
+					break;
+				}
+				case '-': {
+					//Long options
+					std::string const option(argv[i]);
+					if (option == "--profile") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and '--profile' are unusable together\n");
+						if (args_set & Args::T) throw std::invalid_argument("'-o' and '--profile' are unusable together\n");
+						if (args_set & Args::L) throw std::invalid_argument("'--profile' and the batch options are unusable together\n");
+						if (args_set & Args::X) throw std::invalid_argument("'--profile' and the limits are unusable together\n");
+						if (args_set & Args::R) throw std::invalid_argument("'--profile' and the checkpoints are unusable together\n");
+						if (args_set & Args::S) throw std::invalid_argument("'--profile' and '--metrics' are unusable together\n");
+						if (argc == ++i) throw std::invalid_argument("missing filename after '--profile'\n");
+						args_set = args_set | Args::P;
+						interpreter.set_profile(argv[i]);
+					}
+					else if (option == "--max-instructions" || option == "--timeout") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and the limits are unusable together\n");
+						if (args_set & Args::T) throw std::invalid_argument("'-o' and the limits are unusable together\n");
+						if (args_set & Args::P) throw std::invalid_argument("'--profile' and the limits are unusable together\n");
+						if (args_set & Args::R) throw std::invalid_argument("The limits and the checkpoints are unusable together\n");
+						if (argc == ++i) throw std::invalid_argument("missing value after '" + option + "'\n");
+						if (option == "--timeout") {
+							if (!(std::stringstream(argv[i]) >> limits.seconds) || limits.seconds <= 0)
+								throw std::invalid_argument("'--timeout' takes a positive number of seconds\n");
+						}
+						else if (!(std::stringstream(argv[i]) >> limits.instructions) || limits.instructions == 0)
+							throw std::invalid_argument("'--max-instructions' takes a positive integer\n");
+						args_set = args_set | Args::X;
+						interpreter.set_limits(limits);
+					}
+					else if (option == "--checkpoint" || option == "--checkpoint-every" || option == "--resume") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and the checkpoints are unusable together\n");
+						if (args_set & Args::T) throw std::invalid_argument("'-o' and the checkpoints are unusable together\n");
+						if (args_set & Args::L) throw std::invalid_argument("The checkpoints and the batch options are unusable together\n");
+						if (args_set & Args::P) throw std::invalid_argument("'--profile' and the checkpoints are unusable together\n");
+						if (args_set & Args::X) throw std::invalid_argument("The limits and the checkpoints are unusable together\n");
+						if (args_set & Args::N) throw std::invalid_argument("'-n' and the checkpoints are unusable together\n");
+						if (args_set & Args::S) throw std::invalid_argument("The checkpoints and '--metrics' are unusable together\n");
+						if (argc == ++i) throw std::invalid_argument("missing value after '" + option + "'\n");
+						if (option == "--checkpoint") checkpoint = argv[i];
+						else if (option == "--resume") interpreter.set_resume(argv[i]);
+						else if (!(std::stringstream(argv[i]) >> checkpoint_period) || checkpoint_period <= 0)
+							throw std::invalid_argument("'--checkpoint-every' takes a positive number of seconds\n");
+						args_set = args_set | Args::R;
+						interpreter.set_checkpoint(checkpoint, checkpoint_period);
+					}
+					else if (option == "--cache") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and '--cache' are unusable together\n");
+						if (argc == ++i) throw std::invalid_argument("missing directory after '--cache'\n");
+						args_set = args_set | Args::K;
+						interpreter.set_cache(argv[i]);
+					}
+					else if (option == "--parallel") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and '--parallel' are unusable together\n");
+						if (args_set & Args::S) throw std::invalid_argument("'--parallel' and '--metrics' are unusable together\n");
+						args_set = args_set | Args::Q;
+						interpreter.set_parallel(true);
+					}
+					else if (option == "--metrics") {
+						if (args_set & Args::C) throw std::invalid_argument("'-c' and '--metrics' are unusable together\n");
+						if (args_set & Args::T) throw std::invalid_argument("'-o' and '--metrics' are unusable together\n");
+						if (args_set & Args::L) throw std::invalid_argument("'--metrics' and the batch options are unusable together\n");
+						if (args_set & Args::P) throw std::invalid_argument("'--profile' and '--metrics' are unusable together\n");
+						if (args_set & Args::R) throw std::invalid_argument("The checkpoints and '--metrics' are unusable together\n");
+						if (args_set & Args::Q) throw std::invalid_argument("'--parallel' and '--metrics' are unusable together\n");
+						if (argc == ++i) throw std::invalid_argument("missing filename after '--metrics'\n");
+						args_set = args_set | Args::S;
+						interpreter.set_metrics(argv[i]);
+					}
+					else throw std::invalid_argument("Argument unknown\n");
+					break;
+				}
 				}
 				//If the '-h' arg has been used we don't need to check for other args
 				if (args_set & Args::H) break;
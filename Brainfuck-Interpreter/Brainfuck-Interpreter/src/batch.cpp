@@ -0,0 +1,203 @@
+#include "batch.h"
+
+#include "io.h"
+#include "machine.h"
+#include "source.h"
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+
+//---WORK STEALING---
+
+//Indices of the runs left to each worker, dealt in turn so that the runs end
+//roughly in order, a worker without work takes the last indices of another one
+class WorkQueues
+{
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<size_t> tasks;
+	};
+
+	std::vector<std::unique_ptr<Queue> > m_queues;
+
+public:
+	WorkQueues(size_t const& tasks, size_t const& workers) {
+		for (size_t i(0); i != workers; ++i)
+			m_queues.emplace_back(new Queue());
+		for (size_t task(0); task != tasks; ++task)
+			m_queues[task % workers]->tasks.push_back(task);
+	}
+
+	//Return false once there is no work left
+	bool next(size_t const& worker, size_t& task) {
+		for (size_t i(0); i != m_queues.size(); ++i) {
+			Queue& queue = *m_queues[(worker + i) % m_queues.size()];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty()) continue;
+			if (i == 0) {
+				task = queue.tasks.front();
+				queue.tasks.pop_front();
+			}
+			else {
+				task = queue.tasks.back();
+				queue.tasks.pop_back();
+			}
+			return true;
+		}
+		return false;
+	}
+};
+
+//---RESULTS---
+
+//Outputs of the runs waiting to be written
+struct Results {
+	std::mutex mutex;
+	std::condition_variable ready;
+	std::vector<std::string> outputs;
+	std::vector<std::string> errors;
+	std::vector<char> done;
+	//Runs in the order they ended
+	std::deque<size_t> ended;
+};
+
+static std::vector<std::string> read_list(std::string const& path) {
+	std::ifstream f(path);
+	if (f.fail()) throw std::invalid_argument("Unable to open the list of inputs\n");
+	std::vector<std::string> paths;
+	std::string line;
+	while (std::getline(f, line))
+		if (!line.empty()) paths.push_back(line);
+	return paths;
+}
+
+//Split the content in records, a last delimiter doesn't start an empty record
+static std::vector<std::pair<char const*, size_t> > split_records(BFSource const& source, char const& delimiter) {
+	std::vector<std::pair<char const*, size_t> > records;
+	char const* first = source.begin();
+	for (char const* read = first; read != source.end(); ++read) {
+		if (*read != delimiter) continue;
+		records.push_back(std::make_pair(first, read - first));
+		first = read + 1;
+	}
+	if (first != source.end()) records.push_back(std::make_pair(first, source.end() - first));
+	return records;
+}
+
+//---BATCH---
+
+void run_batch(BFProgram const& program, BFJit const* jit, BFPrefix const* prefix, BatchOptions const& options) {
+	std::vector<std::string> paths;
+	std::unique_ptr<BFSource> stream;
+	std::vector<std::pair<char const*, size_t> > records;
+	if (!options.list.empty()) paths = read_list(options.list);
+	else {
+		stream.reset(new BFSource("/dev/stdin"));
+		records = split_records(*stream, options.delimiter);
+	}
+	size_t const count = options.list.empty() ? records.size() : paths.size();
+	auto key = [&](size_t const& task) {
+		return options.list.empty() ? std::to_string(task + 1) : paths[task];
+	};
+
+	size_t workers = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+	if (workers == 0) workers = 1;
+	if (workers > count) workers = count;
+	//The machines are made here so that their errors reach the caller
+	std::vector<std::unique_ptr<BFMachine> > machines;
+	for (size_t i(0); i != workers; ++i) {
+		machines.emplace_back(new BFMachine(options.tape_kind, options.tape_size, options.cell_bits, options.negative_cells));
+		machines.back()->set_limits(options.limits);
+		machines.back()->set_prefix(prefix);
+	}
+
+	WorkQueues queues(count, workers);
+	Results results;
+	results.outputs.resize(count);
+	results.errors.resize(count);
+	results.done.resize(count, 0);
+
+	auto work = [&](size_t const& worker) {
+		BFMachine& machine = *machines[worker];
+		std::ostringstream buffer;
+		BFOutput out(buffer);
+		size_t task;
+		while (queues.next(worker, task)) {
+			std::string error;
+			try {
+				std::unique_ptr<BFSource> file;
+				char const* data;
+				size_t size;
+				if (options.list.empty()) {
+					data = records[task].first;
+					size = records[task].second;
+				}
+				else {
+					file.reset(new BFSource(paths[task]));
+					data = file->begin();
+					size = file->size();
+				}
+				BFInput in(data, size);
+				if (jit) machine.run(*jit, in, out);
+				else machine.run(program, in, out);
+			}
+			catch (std::exception const& e) {
+				error = e.what();
+			}
+			//The output written before an error is kept
+			out.flush();
+			std::string output = buffer.str();
+			buffer.str(std::string());
+
+			std::lock_guard<std::mutex> lock(results.mutex);
+			results.outputs[task].swap(output);
+			results.errors[task].swap(error);
+			results.done[task] = 1;
+			results.ended.push_back(task);
+			results.ready.notify_one();
+		}
+	};
+	std::vector<std::thread> threads;
+	for (size_t i(0); i != workers; ++i)
+		threads.emplace_back(work, i);
+
+	std::cout.flush();
+	BFOutput writer(STDOUT_FILENO);
+	std::unique_lock<std::mutex> lock(results.mutex);
+	for (size_t written(0); written != count; ++written) {
+		results.ready.wait(lock, [&]() {
+			return options.keyed ? !results.ended.empty() : results.done[written] != 0;
+		});
+		size_t task = written;
+		if (options.keyed) {
+			task = results.ended.front();
+			results.ended.pop_front();
+		}
+		lock.unlock();
+		if (!results.errors[task].empty()) {
+			writer.flush();
+			std::cerr << key(task) << ": " << results.errors[task];
+		}
+		if (options.keyed) {
+			std::string const name = key(task);
+			writer.write(name.data(), name.size());
+			writer.put('\t');
+		}
+		writer.write(results.outputs[task].data(), results.outputs[task].size());
+		writer.put(options.delimiter);
+		std::string().swap(results.outputs[task]);
+		lock.lock();
+	}
+	lock.unlock();
+	for (std::thread& thread : threads)
+		thread.join();
+	writer.flush();
+	if (writer.fail()) throw std::runtime_error("Unable to write the results of the batch\n");
+}
@@ -10,10 +10,49 @@ invalid_argument_number::invalid_argument_number(std::string const& command, std
 
 const char* invalid_argument_number::what() const throw() { return e_what; };
 
-cell_out_of_range::cell_out_of_range(int const& cell) {
+cell_out_of_range::cell_out_of_range(long const& cell) {
 	std::stringstream ss;
 	ss << "Cell " << cell << " is out of bounds\n";
-	e_what = std::string(ss.str()).c_str();
+	e_what = ss.str();
 };
 
-const char* cell_out_of_range::what() const throw() { return e_what; };
\ No newline at end of file
+const char* cell_out_of_range::what() const throw() { return e_what.c_str(); };
+
+static std::string tape_out_of_bounds_message(long const& cell) {
+	std::stringstream ss;
+	ss << "Cell " << cell << " is out of the tape\n";
+	return ss.str();
+}
+
+tape_out_of_bounds::tape_out_of_bounds(long const& cell) :
+	std::runtime_error(tape_out_of_bounds_message(cell)) {};
+
+static std::string unbalanced_brackets_message(char const& bracket, size_t const& position) {
+	std::stringstream ss;
+	ss << "Unmatched '" << bracket << "' at position " << position << " of the code\n";
+	return ss.str();
+}
+
+unbalanced_brackets::unbalanced_brackets(char const& bracket, size_t const& position) :
+	std::runtime_error(unbalanced_brackets_message(bracket, position)) {};
+
+static std::string output_overflow_message(size_t const& capacity) {
+	std::stringstream ss;
+	ss << "The output doesn't fit in the " << capacity << " bytes given for it\n";
+	return ss.str();
+}
+
+output_overflow::output_overflow(size_t const& capacity) :
+	std::runtime_error(output_overflow_message(capacity)) {};
+
+static std::string limit_exceeded_message(bool const& timeout, unsigned long long const& instructions,
+										  double const& seconds, long const& cell) {
+	std::stringstream ss;
+	ss << "Stopped after " << instructions << " instructions and " << seconds << " seconds, "
+		<< (timeout ? "the time limit is reached" : "the instruction budget is spent")
+		<< ", the pointer is on cell " << cell << '\n';
+	return ss.str();
+}
+
+limit_exceeded::limit_exceeded(bool const& timeout, unsigned long long const& instructions, double const& seconds, long const& cell) :
+	std::runtime_error(limit_exceeded_message(timeout, instructions, seconds, cell)) {};
@@ -0,0 +1,59 @@
+#include "budget.h"
+
+#include <algorithm>
+
+const unsigned long long BFBudget::CHECK_INTERVAL = 1 << 20;
+
+BFBudget::BFBudget(BFLimits const& limits) :
+	m_limits(limits) {
+	start();
+}
+
+void BFBudget::start() {
+	m_start = std::chrono::steady_clock::now();
+	//The first back-edge checks the caps and gives the first allowance
+	m_spent = 0;
+	m_allowance = 0;
+	m_left = 0;
+	m_timeout = false;
+	m_exhausted = false;
+}
+
+unsigned long long BFBudget::left() const throw() {
+	return m_left;
+}
+
+void BFBudget::set_left(unsigned long long const& left) throw() {
+	m_left = left;
+}
+
+unsigned long long BFBudget::spent() const throw() {
+	return m_spent + m_allowance - m_left;
+}
+
+double BFBudget::seconds() const {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+bool BFBudget::timeout() const throw() {
+	return m_timeout;
+}
+
+bool BFBudget::exhausted() const throw() {
+	return m_exhausted;
+}
+
+bool BFBudget::renew(unsigned long long const& instructions) {
+	m_spent += m_allowance - m_left;
+	m_allowance = 0;
+	m_left = 0;
+	if (m_limits.instructions != 0 && m_spent + instructions > m_limits.instructions) m_exhausted = true;
+	else if (m_limits.seconds != 0 && seconds() >= m_limits.seconds) m_timeout = true;
+	//The iteration refused is not spent
+	if (m_exhausted || m_timeout) return false;
+	m_spent += instructions;
+	m_allowance = CHECK_INTERVAL;
+	if (m_limits.instructions != 0) m_allowance = std::min(m_allowance, m_limits.instructions - m_spent);
+	m_left = m_allowance;
+	return true;
+}
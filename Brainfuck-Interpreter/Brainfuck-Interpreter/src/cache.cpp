@@ -0,0 +1,295 @@
+#include "cache.h"
+
+#include "analysis.h"
+#include "prefix.h"
+#include "source.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char MAGIC[4] = { 'B', 'F', 'P', 'C' };
+static const uint32_t VERSION = 3;
+
+//Start of the file
+struct CacheHeader {
+	char magic[4];
+	uint32_t version;
+	uint64_t key;
+	uint32_t optimization;
+	uint32_t bounded;
+	int64_t lowest;
+	int64_t highest;
+	int64_t shift;
+	uint64_t size;
+	//Width of the cells the prefix was run on
+	uint32_t cell_bits;
+	uint32_t padding;
+	//State left by the prefix, it has no cells and no output when its instruction is 0
+	uint64_t prefix;
+	int64_t position;
+	uint64_t reach;
+	uint64_t cells;
+	uint64_t output;
+	//Brainfuck characters of the source, the key alone may be shared by two sources
+	uint64_t source;
+};
+
+//Instruction as stored in the file, the padding is zero
+struct CacheRecord {
+	uint8_t op;
+	uint8_t padding[3];
+	int32_t arg;
+	int32_t offset;
+};
+
+//Cell of the prefix that is not zero
+struct CacheCell {
+	int64_t cell;
+	uint64_t value;
+};
+
+//---KEY---
+
+uint64_t hash_source(char const* first, char const* last, Optimization const& optimization,
+					 unsigned int const& cell_bits) throw() {
+	//FNV-1a of the version, the optimizations, the width of the cells and the brainfuck characters
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&](unsigned char byte) {
+		hash ^= byte;
+		hash *= 1099511628211ULL;
+	};
+	mix(static_cast<unsigned char>(VERSION));
+	mix(static_cast<unsigned char>(optimization));
+	mix(static_cast<unsigned char>(cell_bits));
+	for (char const* read = first; read != last; ++read)
+		if (is_brainfuck_char(*read)) mix(static_cast<unsigned char>(*read));
+	return hash;
+}
+
+//Brainfuck characters of the source, the ones the program is compiled from
+static std::string filter_source(char const* first, char const* last) {
+	std::string source;
+	for (char const* read = first; read != last; ++read)
+		if (is_brainfuck_char(*read)) source.push_back(*read);
+	return source;
+}
+
+//---PLACES---
+
+//The places are stored as the number of brainfuck characters before them, so
+//that the sources differing only by their comments share the same file
+static void convert_places(std::vector<size_t>& places, char const* first, char const* last, bool const& to_stored) {
+	std::vector<size_t> order(places.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return places[a] < places[b]; });
+	std::vector<size_t> converted(places.size(), 0);
+	size_t characters(0);
+	auto next = order.begin();
+	for (char const* read = first; read != last && next != order.end(); ++read) {
+		if (!is_brainfuck_char(*read)) continue;
+		size_t const place = to_stored ? read - first : characters;
+		for (; next != order.end() && places[*next] == place; ++next)
+			converted[*next] = to_stored ? characters : read - first;
+		++characters;
+	}
+	places.swap(converted);
+}
+
+//---FILE---
+
+static size_t places_offset(size_t const& size) {
+	size_t const end = sizeof(CacheHeader) + size * sizeof(CacheRecord);
+	return (end + 7) / 8 * 8;
+}
+
+static size_t cells_offset(size_t const& size) {
+	return places_offset(size) + size * sizeof(uint64_t);
+}
+
+//True when no loop crosses the end of the prefix, the rest of the program
+//would jump out of its instructions
+static bool is_prefix_end(std::vector<Instruction> const& instructions, size_t const& prefix) {
+	for (size_t i(0); i != instructions.size(); ++i)
+		if ((instructions[i].op == OpCode::OPEN || instructions[i].op == OpCode::CLOSE)
+			&& (i < prefix) != (static_cast<size_t>(instructions[i].arg) < prefix))
+			return false;
+	return true;
+}
+
+//True when the compiler could have made the instructions, the brackets pair
+//up, each RESERVE is before a '[' and holds the bounds of its loop, and the
+//bounds are the ones of the code, the loops run without checks rely on them
+static bool is_valid_code(std::vector<Instruction> const& instructions, Optimization const& optimization,
+						  BFBounds const& bounds) {
+	std::vector<size_t> open;
+	for (size_t i(0); i != instructions.size(); ++i) {
+		Instruction const& action = instructions[i];
+		if (action.op == OpCode::OPEN) open.push_back(i);
+		else if (action.op == OpCode::CLOSE) {
+			if (open.empty() || static_cast<size_t>(action.arg) != open.back()
+				|| static_cast<size_t>(instructions[open.back()].arg) != i)
+				return false;
+			open.pop_back();
+		}
+		else if (action.op == OpCode::RESERVE
+				 && (!(optimization & Optimization::bounds) || i + 1 == instructions.size()
+					 || instructions[i + 1].op != OpCode::OPEN))
+			return false;
+	}
+	if (!open.empty()) return false;
+
+	BFAnalysis const analysis(instructions);
+	for (size_t i(0); i != instructions.size(); ++i) {
+		if (instructions[i].op != OpCode::RESERVE) continue;
+		BFBounds const& loop = analysis.loop(i + 1);
+		if (!loop.bounded || loop.lowest != instructions[i].arg || loop.highest != instructions[i].offset) return false;
+	}
+	BFBounds expected = { false, 0, 0, 0 };
+	if (optimization & Optimization::bounds) expected = analysis.program();
+	return bounds.bounded == expected.bounded && bounds.lowest == expected.lowest
+		&& bounds.highest == expected.highest && bounds.shift == expected.shift;
+}
+
+static std::string cache_path(std::string const& directory, uint64_t const& key) {
+	std::stringstream ss;
+	ss << directory << '/' << std::hex << std::setw(16) << std::setfill('0') << key << ".bfc";
+	return ss.str();
+}
+
+//False when there is no usable program for the source in the file
+static bool load_program(std::string const& path, uint64_t const& key, char const* first, char const* last,
+						 std::string const& source, Optimization const& optimization, unsigned int const& cell_bits,
+						 BFProgram& program) {
+	std::unique_ptr<BFSource> file;
+	try {
+		file.reset(new BFSource(path));
+	}
+	catch (std::invalid_argument const&) {
+		return false;
+	}
+	CacheHeader header;
+	if (file->size() < sizeof(header)) return false;
+	std::memcpy(&header, file->begin(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION || header.key != key
+		|| header.optimization != static_cast<uint32_t>(optimization) || header.cell_bits != cell_bits
+		|| header.size > file->size() / sizeof(CacheRecord) || header.prefix > header.size
+		|| header.cells > file->size() / sizeof(CacheCell) || header.output > file->size()
+		|| header.source != source.size()
+		|| file->size() != cells_offset(header.size) + header.cells * sizeof(CacheCell) + header.output + header.source)
+		return false;
+	char const* stored_source = file->begin() + cells_offset(header.size) + header.cells * sizeof(CacheCell) + header.output;
+	if (source.compare(0, source.size(), stored_source, header.source) != 0) return false;
+
+	std::vector<Instruction> instructions(header.size);
+	char const* records = file->begin() + sizeof(header);
+	for (size_t i(0); i != instructions.size(); ++i) {
+		CacheRecord record;
+		std::memcpy(&record, records + i * sizeof(record), sizeof(record));
+		if (record.op > static_cast<uint8_t>(OpCode::RESERVE)) return false;
+		instructions[i] = { static_cast<OpCode>(record.op), record.arg, record.offset };
+	}
+	//A damaged or stale program would run loops without checks out of the tape
+	BFBounds const bounds = { header.bounded != 0, header.lowest, header.highest, header.shift };
+	if (!is_valid_code(instructions, optimization, bounds) || !is_prefix_end(instructions, header.prefix)) return false;
+	std::vector<size_t> places(header.size);
+	char const* stored = file->begin() + places_offset(header.size);
+	for (size_t i(0); i != places.size(); ++i) {
+		uint64_t place;
+		std::memcpy(&place, stored + i * sizeof(place), sizeof(place));
+		places[i] = place;
+	}
+	convert_places(places, first, last, false);
+	program = BFProgram(instructions, places, optimization, bounds, last - first);
+
+	BFPrefix prefix;
+	prefix.instruction = header.prefix;
+	if (prefix.instruction != 0) prefix.cell_bits = header.cell_bits;
+	prefix.position = header.position;
+	prefix.reach = header.reach;
+	prefix.cells.resize(header.cells);
+	char const* cells = file->begin() + cells_offset(header.size);
+	for (size_t i(0); i != prefix.cells.size(); ++i) {
+		CacheCell cell;
+		std::memcpy(&cell, cells + i * sizeof(cell), sizeof(cell));
+		prefix.cells[i] = { cell.cell, cell.value };
+	}
+	prefix.output.assign(cells + header.cells * sizeof(CacheCell), header.output);
+	program.set_prefix(prefix);
+	return true;
+}
+
+static void save_program(std::string const& directory, std::string const& path, uint64_t const& key,
+						 char const* first, char const* last, std::string const& source, unsigned int const& cell_bits,
+						 BFProgram const& program) {
+	std::vector<Instruction> const& instructions = program.instructions();
+	CacheHeader header;
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.optimization = static_cast<uint32_t>(program.optimization());
+	header.bounded = program.bounds().bounded;
+	header.lowest = program.bounds().lowest;
+	header.highest = program.bounds().highest;
+	header.shift = program.bounds().shift;
+	header.size = instructions.size();
+	BFPrefix const& prefix = program.prefix();
+	header.prefix = prefix.instruction;
+	header.cell_bits = cell_bits;
+	header.padding = 0;
+	header.position = prefix.position;
+	header.reach = prefix.reach;
+	header.cells = prefix.cells.size();
+	header.output = prefix.output.size();
+	header.source = source.size();
+
+	size_t const cells = cells_offset(instructions.size());
+	size_t const output = cells + prefix.cells.size() * sizeof(CacheCell);
+	std::string data(output + prefix.output.size() + source.size(), '\0');
+	std::memcpy(&data[0], &header, sizeof(header));
+	for (size_t i(0); i != instructions.size(); ++i) {
+		CacheRecord record = { static_cast<uint8_t>(instructions[i].op), { 0, 0, 0 }, instructions[i].arg, instructions[i].offset };
+		std::memcpy(&data[sizeof(header) + i * sizeof(record)], &record, sizeof(record));
+	}
+	std::vector<size_t> places(program.sources());
+	convert_places(places, first, last, true);
+	for (size_t i(0); i != places.size(); ++i) {
+		uint64_t const place = places[i];
+		std::memcpy(&data[places_offset(instructions.size()) + i * sizeof(place)], &place, sizeof(place));
+	}
+	for (size_t i(0); i != prefix.cells.size(); ++i) {
+		CacheCell const cell = { prefix.cells[i].first, prefix.cells[i].second };
+		std::memcpy(&data[cells + i * sizeof(cell)], &cell, sizeof(cell));
+	}
+	std::copy(prefix.output.begin(), prefix.output.end(), data.begin() + output);
+	std::copy(source.begin(), source.end(), data.begin() + output + prefix.output.size());
+
+	mkdir(directory.c_str(), 0777);
+	//Written aside and renamed, the runs reading the cache at the same time never see half a file
+	std::stringstream temporary;
+	temporary << path << '.' << getpid() << ".tmp";
+	std::ofstream f(temporary.str(), std::ios::binary | std::ios::trunc);
+	f.write(data.data(), data.size());
+	f.close();
+	if (f.fail() || std::rename(temporary.str().c_str(), path.c_str()) != 0) std::remove(temporary.str().c_str());
+}
+
+BFProgram compile_cached(std::string const& directory, char const* first, char const* last,
+						 Optimization const& optimization, unsigned int const& cell_bits, BFLimits const& limits) {
+	uint64_t const key = hash_source(first, last, optimization, cell_bits);
+	std::string const path = cache_path(directory, key);
+	std::string const source = filter_source(first, last);
+	BFProgram program;
+	if (load_program(path, key, first, last, source, optimization, cell_bits, program)) return program;
+	program = BFProgram(first, last, optimization);
+	if ((optimization & Optimization::prefix) && limits.empty()) program.set_prefix(evaluate_prefix(program, cell_bits));
+	save_program(directory, path, key, first, last, source, cell_bits, program);
+	return program;
+}
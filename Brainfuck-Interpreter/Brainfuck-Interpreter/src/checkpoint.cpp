@@ -0,0 +1,162 @@
+#include "checkpoint.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <sys/time.h>
+
+static const char MAGIC[4] = { 'B', 'F', 'C', 'K' };
+static const uint64_t VERSION = 1;
+
+//---HASH---
+
+uint64_t hash_program(BFProgram const& program) throw() {
+	//FNV-1a of the fields of each instruction
+	uint64_t hash = 14695981039346656037ULL;
+	auto mix = [&](uint64_t value) {
+		for (int byte(0); byte != 8; ++byte) {
+			hash ^= (value >> (8 * byte)) & 0xff;
+			hash *= 1099511628211ULL;
+		}
+	};
+	for (Instruction const& action : program.instructions()) {
+		mix(static_cast<uint64_t>(action.op));
+		mix(static_cast<uint32_t>(action.arg));
+		mix(static_cast<uint32_t>(action.offset));
+	}
+	return hash;
+}
+
+//---ENCODING---
+
+static void put_varint(std::string& data, uint64_t value) {
+	while (value >= 0x80) {
+		data += static_cast<char>((value & 0x7f) | 0x80);
+		value >>= 7;
+	}
+	data += static_cast<char>(value);
+}
+
+static uint64_t get_varint(std::string const& data, size_t& read, std::string const& path) {
+	uint64_t value(0);
+	for (int shift(0); shift < 64; shift += 7) {
+		if (read == data.size()) break;
+		unsigned char byte = static_cast<unsigned char>(data[read++]);
+		value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+		if (!(byte & 0x80)) return value;
+	}
+	throw std::runtime_error("'" + path + "' is not a valid checkpoint\n");
+}
+
+void save_checkpoint(std::string const& path, BFCheckpoint const& checkpoint) {
+	std::string data(MAGIC, sizeof(MAGIC));
+	put_varint(data, VERSION);
+	put_varint(data, checkpoint.cell_bits);
+	put_varint(data, checkpoint.program);
+	put_varint(data, checkpoint.instruction);
+	put_varint(data, checkpoint.position);
+	put_varint(data, checkpoint.input);
+	put_varint(data, checkpoint.output);
+	std::vector<uint32_t> const& cells = checkpoint.cells;
+	put_varint(data, cells.size());
+	for (size_t cell(0); cell != cells.size();) {
+		size_t zeros(cell);
+		while (zeros != cells.size() && cells[zeros] == 0) ++zeros;
+		size_t values(zeros);
+		while (values != cells.size() && cells[values] != 0) ++values;
+		put_varint(data, zeros - cell);
+		put_varint(data, values - zeros);
+		for (size_t i(zeros); i != values; ++i)
+			put_varint(data, cells[i]);
+		cell = values;
+	}
+
+	std::string const temporary = path + ".tmp";
+	std::ofstream f(temporary, std::ios::binary | std::ios::trunc);
+	f.write(data.data(), data.size());
+	f.close();
+	if (f.fail() || std::rename(temporary.c_str(), path.c_str()) != 0)
+		throw std::runtime_error("Unable to write the checkpoint '" + path + "'\n");
+}
+
+BFCheckpoint load_checkpoint(std::string const& path) {
+	std::ifstream f(path, std::ios::binary);
+	if (f.fail()) throw std::runtime_error("Unable to open the checkpoint '" + path + "'\n");
+	std::string const data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+	if (data.size() < sizeof(MAGIC) || std::memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0)
+		throw std::runtime_error("'" + path + "' is not a checkpoint\n");
+	size_t read = sizeof(MAGIC);
+	if (get_varint(data, read, path) != VERSION)
+		throw std::runtime_error("The checkpoint '" + path + "' was written by another version\n");
+
+	BFCheckpoint checkpoint;
+	checkpoint.cell_bits = static_cast<unsigned int>(get_varint(data, read, path));
+	checkpoint.program = get_varint(data, read, path);
+	checkpoint.instruction = get_varint(data, read, path);
+	checkpoint.position = get_varint(data, read, path);
+	checkpoint.input = get_varint(data, read, path);
+	checkpoint.output = get_varint(data, read, path);
+	uint64_t const count = get_varint(data, read, path);
+	while (checkpoint.cells.size() != count) {
+		uint64_t const zeros = get_varint(data, read, path);
+		uint64_t const values = get_varint(data, read, path);
+		if (zeros + values > count - checkpoint.cells.size())
+			throw std::runtime_error("'" + path + "' is not a valid checkpoint\n");
+		checkpoint.cells.resize(checkpoint.cells.size() + zeros, 0);
+		for (uint64_t i(0); i != values; ++i)
+			checkpoint.cells.push_back(static_cast<uint32_t>(get_varint(data, read, path)));
+	}
+	return checkpoint;
+}
+
+//---TRIGGER---
+
+volatile std::sig_atomic_t BFCheckpointTrigger::s_requested = 0;
+volatile std::sig_atomic_t BFCheckpointTrigger::s_terminated = 0;
+
+void BFCheckpointTrigger::on_signal(int signal) {
+	if (signal == SIGTERM) s_terminated = 1;
+	s_requested = 1;
+}
+
+void BFCheckpointTrigger::install(double const& period) {
+	clear();
+	s_terminated = 0;
+	struct sigaction action;
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = &on_signal;
+	sigemptyset(&action.sa_mask);
+	//A read waiting for input is interrupted so that the checkpoint is written,
+	//the writes go on
+	action.sa_flags = 0;
+	sigaction(SIGTERM, &action, nullptr);
+	if (period <= 0) return;
+	sigaction(SIGALRM, &action, nullptr);
+	struct itimerval timer;
+	timer.it_interval.tv_sec = static_cast<time_t>(period);
+	timer.it_interval.tv_usec = static_cast<suseconds_t>((period - timer.it_interval.tv_sec) * 1e6);
+	timer.it_value = timer.it_interval;
+	setitimer(ITIMER_REAL, &timer, nullptr);
+}
+
+void BFCheckpointTrigger::uninstall() {
+	struct itimerval timer;
+	std::memset(&timer, 0, sizeof(timer));
+	setitimer(ITIMER_REAL, &timer, nullptr);
+	std::signal(SIGALRM, SIG_DFL);
+	std::signal(SIGTERM, SIG_DFL);
+}
+
+bool BFCheckpointTrigger::terminated() throw() {
+	return s_terminated != 0;
+}
+
+void BFCheckpointTrigger::clear() throw() {
+	s_requested = 0;
+}
+
+bool BFCheckpointTrigger::requested() throw() {
+	return s_requested != 0;
+}
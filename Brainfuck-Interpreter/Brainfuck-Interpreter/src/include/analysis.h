@@ -0,0 +1,50 @@
+#ifndef BRAINFUCKCONSOLE_SRC_ANALYSIS_H_
+#define BRAINFUCKCONSOLE_SRC_ANALYSIS_H_
+
+#include <vector>
+#include "program.h"
+
+//Outermost loop of a group, from its RESERVE or its '[' to its ']'
+struct BFRegion {
+	size_t first;
+	size_t last;
+	//Pointer on its '[' from the pointer where the group starts
+	long shift;
+};
+
+//Outermost balanced loops following each other with only moves between them,
+//which read and write nothing and whose cells are used by no other loop of
+//the group, so that they can run at the same time
+struct BFLoopGroup {
+	//Instructions of the group, from its first loop to its last one
+	size_t begin;
+	size_t end;
+	//Cells used by all the loops, the pointer ends shifted to the last '['
+	BFBounds bounds;
+	std::vector<BFRegion> loops;
+};
+
+//Pointer movements of a compiled program known without running it
+//A loop is balanced when each iteration ends on the cell it started from and
+//its inner loops are balanced, the cells it uses are then known from the
+//pointer on its '[' however many times it runs
+class BFAnalysis
+{
+private:
+	//Bounds of one iteration of each loop, kept on its '['
+	std::vector<BFBounds> m_loops;
+	BFBounds m_program;
+
+public:
+	explicit BFAnalysis(std::vector<Instruction> const& code);
+
+	//The loop is balanced when its bounds are known
+	BFBounds const& loop(size_t const& open) const throw();
+	//The whole program is bounded when it has no scan and all its loops are balanced
+	BFBounds const& program() const throw();
+	//Groups of at least two independent loops among the outermost loops of the
+	//analysed code, in order
+	std::vector<BFLoopGroup> independent_loops(std::vector<Instruction> const& code) const;
+};
+
+#endif
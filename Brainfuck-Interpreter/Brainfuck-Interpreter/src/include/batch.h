@@ -0,0 +1,38 @@
+#ifndef BRAINFUCKCONSOLE_SRC_BATCH_H_
+#define BRAINFUCKCONSOLE_SRC_BATCH_H_
+
+#include <string>
+#include "budget.h"
+#include "jit.h"
+#include "program.h"
+#include "tape.h"
+
+//Where a batch takes its inputs and how it writes its results
+struct BatchOptions {
+	//File listing one input file per line, when it is empty the standard
+	//input is split in records at each delimiter
+	std::string list;
+	//Written after each result
+	char delimiter = '\n';
+	//Write each result as soon as it is ready after its input file or record
+	//number and a tab, instead of writing them in the order of the inputs
+	bool keyed = false;
+	//0 uses every core
+	unsigned int threads = 0;
+	TapeKind tape_kind = TapeKind::vector;
+	size_t tape_size = 0;
+	bool negative_cells = false;
+	unsigned int cell_bits = 8;
+	//Caps of each run, the native code must be limited when there are some
+	BFLimits limits;
+};
+
+//Run the program once for each input on a pool of threads, each thread runs
+//on its own machine and a thread without work takes work from the others
+//The native code is used instead of the program when it is given
+//Each run starts from the state left by the prefix when it is given, the
+//program and the native code are then the rest of the program
+//The results are written on the standard output and the errors on the error output
+void run_batch(BFProgram const& program, BFJit const* jit, BFPrefix const* prefix, BatchOptions const& options);
+
+#endif
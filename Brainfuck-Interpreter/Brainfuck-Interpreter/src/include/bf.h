@@ -0,0 +1,14 @@
+#ifndef BRAINFUCKCONSOLE_SRC_BF_H_
+#define BRAINFUCKCONSOLE_SRC_BF_H_
+
+//Interface of libbf
+//A program is compiled once in a BFProgram, or in a BFJit for native code,
+//and run on as many BFMachine as needed
+#include "bfexception.h"
+#include "io.h"
+#include "jit.h"
+#include "machine.h"
+#include "program.h"
+#include "tape.h"
+
+#endif
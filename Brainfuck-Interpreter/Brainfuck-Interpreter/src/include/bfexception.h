@@ -2,6 +2,7 @@
 #define BRAINFUCKCONSOLE_SRC_BFEXCEPTION_H_
 
 #include <exception>
+#include <stdexcept>
 #include <string>
 
 struct invalid_argument_number : std::exception {
@@ -13,11 +14,29 @@ struct invalid_argument_number : std::exception {
 };
 
 struct cell_out_of_range : std::exception {
-	const char* e_what;
+	std::string e_what;
 
-	cell_out_of_range(int const& cell);
+	cell_out_of_range(long const& cell);
 
 	const char* what() const throw();
 };
 
+struct tape_out_of_bounds : std::runtime_error {
+	tape_out_of_bounds(long const& cell);
+};
+
+struct unbalanced_brackets : std::runtime_error {
+	unbalanced_brackets(char const& bracket, size_t const& position);
+};
+
+struct output_overflow : std::runtime_error {
+	output_overflow(size_t const& capacity);
+};
+
+//The run was stopped by its instruction budget or its time limit, the output
+//written and the tape are kept as they were
+struct limit_exceeded : std::runtime_error {
+	limit_exceeded(bool const& timeout, unsigned long long const& instructions, double const& seconds, long const& cell);
+};
+
 #endif
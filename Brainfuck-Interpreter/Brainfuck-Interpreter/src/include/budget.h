@@ -0,0 +1,71 @@
+#ifndef BRAINFUCKCONSOLE_SRC_BUDGET_H_
+#define BRAINFUCKCONSOLE_SRC_BUDGET_H_
+
+#include <chrono>
+#include <cstddef>
+
+//Caps on a run, 0 is no cap
+struct BFLimits {
+	unsigned long long instructions = 0;
+	double seconds = 0;
+
+	bool empty() const throw() {
+		return instructions == 0 && seconds == 0;
+	}
+};
+
+//Instructions and time left to a run
+//Only the back-edges of the loops are checked, each new iteration spends the
+//length of its loop, the code outside of the loops always ends
+//The back-edges only count down a small allowance, the caps and the clock are
+//checked each time it is spent
+class BFBudget
+{
+private:
+	BFLimits m_limits;
+	std::chrono::steady_clock::time_point m_start;
+	//Instructions spent before the current allowance
+	unsigned long long m_spent;
+	unsigned long long m_allowance;
+	unsigned long long m_left;
+	bool m_timeout;
+	bool m_exhausted;
+
+public:
+	//Instructions between two checks of the clock
+	static const unsigned long long CHECK_INTERVAL;
+
+	explicit BFBudget(BFLimits const& limits);
+
+	//Start a new run with the whole budget
+	void start();
+
+	//The instructions are only counted by loop
+	void count(size_t const&) throw() {}
+
+	void iteration(size_t const&) throw() {}
+
+	//Spend the length of a loop starting a new iteration, false when the run must stop
+	bool back_edge(unsigned long long const& instructions) {
+		if (instructions < m_left) {
+			m_left -= instructions;
+			return true;
+		}
+		return renew(instructions);
+	}
+
+	//Countdown of the allowance, shared with the native code
+	unsigned long long left() const throw();
+	void set_left(unsigned long long const& left) throw();
+
+	unsigned long long spent() const throw();
+	double seconds() const;
+	//Why the run was stopped
+	bool timeout() const throw();
+	bool exhausted() const throw();
+
+private:
+	bool renew(unsigned long long const& instructions);
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef BRAINFUCKCONSOLE_SRC_CACHE_H_
+#define BRAINFUCKCONSOLE_SRC_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include "budget.h"
+#include "program.h"
+
+//Key of a compiled program, the hash of the brainfuck characters of the source,
+//its comments are skipped, of the optimizations and of the width of the cells
+uint64_t hash_source(char const* first, char const* last, Optimization const& optimization,
+					 unsigned int const& cell_bits) throw();
+
+//Compiled programs kept in a directory so that a source already compiled with
+//the same optimizations is neither parsed nor optimized again
+//Each program is a file named after its key in hexadecimal with '.bfc'
+//The file starts with "BFPC", a version and the key, followed by the bounds of
+//the program and its number of instructions, then by the instructions as
+//records of 12 bytes and the place of each one as a 64 bits number, all in the
+//byte order of the machine at fixed offsets, so that the file is read in
+//place from its mapping
+//With the prefix optimization, the state left by the prefix of the program on
+//cells of the width follows, as its cells that are not zero and its output
+//The file ends with the brainfuck characters of the source, a file whose
+//source differs, whose brackets don't pair up or whose bounds are not the ones
+//of its code is not used
+//A missing, damaged or older file is compiled again and replaced, a cache that
+//can't be written only costs the compilation
+//A run given limits doesn't run the prefix of a program it compiles, which
+//could go past them, its file is kept without a prefix
+BFProgram compile_cached(std::string const& directory, char const* first, char const* last,
+						 Optimization const& optimization, unsigned int const& cell_bits, BFLimits const& limits);
+
+#endif
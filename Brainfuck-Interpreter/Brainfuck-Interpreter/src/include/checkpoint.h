@@ -0,0 +1,65 @@
+#ifndef BRAINFUCKCONSOLE_SRC_CHECKPOINT_H_
+#define BRAINFUCKCONSOLE_SRC_CHECKPOINT_H_
+
+#include <csignal>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "program.h"
+
+//State of a run stopped between two instructions, enough to continue it later
+//The loops need no state of their own, the next instruction is in the compiled code
+struct BFCheckpoint {
+	unsigned int cell_bits;
+	//Hash of the compiled program, a run only continues on the same program
+	uint64_t program;
+	uint64_t instruction;
+	uint64_t position;
+	//Bytes read and written by the program so far
+	uint64_t input;
+	uint64_t output;
+	//Cells from the first one to the last one that may not be zero
+	std::vector<uint32_t> cells;
+};
+
+uint64_t hash_program(BFProgram const& program) throw();
+
+//The file starts with "BFCK" and a version, then every number is stored as a
+//LEB128 varint and the cells as runs of zeros, given by their length only,
+//each followed by a run of other values
+//The file is replaced at once, a checkpoint being written never breaks the last one
+void save_checkpoint(std::string const& path, BFCheckpoint const& checkpoint);
+BFCheckpoint load_checkpoint(std::string const& path);
+
+//Monitor stopping the run at its next back-edge once a checkpoint is asked,
+//by SIGTERM or by a timer
+class BFCheckpointTrigger
+{
+private:
+	static volatile std::sig_atomic_t s_requested;
+	static volatile std::sig_atomic_t s_terminated;
+
+public:
+	//Ask for a checkpoint on SIGTERM and every period seconds when it is not 0
+	static void install(double const& period);
+	static void uninstall();
+	//The checkpoint was asked by SIGTERM, the run must end once it is written
+	static bool terminated() throw();
+	//Forget the request once its checkpoint is written
+	static void clear() throw();
+	//A checkpoint was asked, it stops the reads waiting for input
+	static bool requested() throw();
+
+	void count(size_t const&) throw() {}
+
+	void iteration(size_t const&) throw() {}
+
+	bool back_edge(unsigned long long const&) throw() {
+		return s_requested == 0;
+	}
+
+private:
+	static void on_signal(int signal);
+};
+
+#endif
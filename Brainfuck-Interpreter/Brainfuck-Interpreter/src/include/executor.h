@@ -0,0 +1,242 @@
+#ifndef BRAINFUCKCONSOLE_SRC_EXECUTOR_H_
+#define BRAINFUCKCONSOLE_SRC_EXECUTOR_H_
+
+#include <vector>
+#include "io.h"
+#include "program.h"
+
+//The loops run without checks are kept out of the execution loop, which is
+//slowed down when they are inlined in it
+#if defined(__GNUC__)
+#define BF_NOINLINE __attribute__((noinline))
+#else
+#define BF_NOINLINE
+#endif
+
+//Tape whose cells used by the instructions are known to exist, the pointer is never checked
+template<class Tape>
+class UncheckedTape
+{
+public:
+	typedef typename Tape::cell_type cell_type;
+	static const bool checked = false;
+
+private:
+	Tape& m_tape;
+
+public:
+	explicit UncheckedTape(Tape& tape) :
+		m_tape(tape) {};
+
+	cell_type* begin() throw() {
+		return m_tape.begin();
+	}
+
+	cell_type* moved(cell_type* cell) throw() {
+		return cell;
+	}
+
+	cell_type* reserve(cell_type* cell, int const&) throw() {
+		return cell;
+	}
+
+	cell_type& at(cell_type*& cell, int const& offset) throw() {
+		return cell[offset];
+	}
+
+	cell_type* scan(cell_type* cell, int const& stride) {
+		return m_tape.scan(cell, stride);
+	}
+};
+
+template<class Tape, class Monitor>
+bool execute_range(Tape& tape, typename Tape::cell_type*& cell, Instruction const* first, size_t const& begin,
+				   size_t const& end, BFInput& in, BFOutput& out, Monitor& monitor, size_t& next);
+
+//Run the loop after a RESERVE, the tapes that check the pointer run it without checks
+template<bool Checked>
+struct ReservedLoop {
+	template<class Tape, class Monitor>
+	BF_NOINLINE static bool run(Tape& tape, typename Tape::cell_type*& cell, Instruction const* first,
+								size_t const& open, BFInput& in, BFOutput& out, Monitor& monitor, size_t& next) {
+		UncheckedTape<Tape> unchecked(tape);
+		return execute_range(unchecked, cell, first, open, first[open].arg + 1, in, out, monitor, next);
+	}
+};
+
+//Never called, a tape that doesn't check the pointer runs the loop like any other one
+template<>
+struct ReservedLoop<false> {
+	template<class Tape, class Monitor>
+	static bool run(Tape&, typename Tape::cell_type*&, Instruction const*, size_t const&,
+					BFInput&, BFOutput&, Monitor&, size_t&) {
+		return true;
+	}
+};
+
+//The execution loop jumps from the code of an instruction straight to the
+//code of the next one through a table of labels when the compiler has labels
+//as values, each instruction then has its own indirect jump to predict
+//Otherwise it is a switch in a loop, the instructions are written once for both
+#if defined(__GNUC__)
+#define BF_THREADED
+#define BF_DISPATCH \
+	if (action == last) goto done; \
+	monitor.count(action - first); \
+	goto *LABELS[static_cast<unsigned char>(action->op)];
+#define BF_INSTRUCTION(op) op_##op:
+#define BF_NEXT \
+	++action; \
+	BF_DISPATCH
+#else
+#define BF_INSTRUCTION(op) case OpCode::op:
+#define BF_NEXT break;
+#endif
+
+//Run the instructions from begin to end with the pointer given in pointer,
+//which is set to the last pointed cell
+//Return false when the monitor or an interrupted read stopped the run, next
+//is then the instruction to continue from
+template<class Tape, class Monitor>
+bool execute_range(Tape& tape, typename Tape::cell_type*& pointer, Instruction const* first, size_t const& begin,
+				   size_t const& end, BFInput& in, BFOutput& out, Monitor& monitor, size_t& next) {
+	typedef typename Tape::cell_type Cell;
+	//The hot state is kept in locals
+	Cell* cell = pointer;
+	Instruction const* const last = first + end;
+	Instruction const* action = first + begin;
+#ifdef BF_THREADED
+	//In the order of OpCode
+	static void* const LABELS[] = { &&op_ADD, &&op_MOVE, &&op_OPEN, &&op_CLOSE, &&op_INPUT, &&op_OUTPUT,
+									&&op_CLEAR, &&op_SCAN, &&op_MUL, &&op_RESERVE };
+	BF_DISPATCH
+#else
+	for (; action != last; ++action) {
+		monitor.count(action - first);
+		switch (action->op) {
+#endif
+		BF_INSTRUCTION(ADD)
+			tape.at(cell, action->offset) += action->arg;
+			BF_NEXT
+		BF_INSTRUCTION(MOVE)
+			cell = tape.moved(cell + action->arg);
+			BF_NEXT
+		BF_INSTRUCTION(OPEN)
+			if (*cell == 0) action = first + action->arg;
+			else monitor.iteration(action - first);
+			BF_NEXT
+		BF_INSTRUCTION(CLOSE)
+			if (*cell != 0) {
+				monitor.iteration(action->arg);
+				if (!monitor.back_edge(action - first - action->arg)) {
+					next = action->arg + 1;
+					pointer = cell;
+					return false;
+				}
+				action = first + action->arg;
+			}
+			BF_NEXT
+		BF_INSTRUCTION(INPUT) {
+			char c;
+			Cell& target = tape.at(cell, action->offset);
+			if (in.get(c)) target = static_cast<unsigned char>(c);
+			else if (in.interrupted()) {
+				//The read is made again when the run goes on
+				next = action - first;
+				pointer = cell;
+				return false;
+			}
+			BF_NEXT
+		}
+		BF_INSTRUCTION(OUTPUT)
+			out.put(static_cast<char>(tape.at(cell, action->offset)));
+			BF_NEXT
+		BF_INSTRUCTION(CLEAR)
+			tape.at(cell, action->offset) = 0;
+			BF_NEXT
+		BF_INSTRUCTION(SCAN)
+			cell = tape.scan(cell, action->arg);
+			BF_NEXT
+		BF_INSTRUCTION(MUL)
+			if (*cell != 0) {
+				//Unsigned product so that it wraps like the cells
+				Cell const product = static_cast<Cell>(*cell * static_cast<unsigned int>(action->arg));
+				tape.at(cell, action->offset) += product;
+			}
+			BF_NEXT
+		BF_INSTRUCTION(RESERVE) {
+			//The loop is run with checks when its lowest cell doesn't exist, so
+			//that it stops on the move leaving the tape like the others
+			if (Tape::checked && cell - tape.begin() >= -static_cast<long>(action->arg)) {
+				cell = tape.reserve(cell, action->offset);
+				size_t const open = action - first + 1;
+				if (!ReservedLoop<Tape::checked>::run(tape, cell, first, open, in, out, monitor, next)) {
+					pointer = cell;
+					return false;
+				}
+				//Go on after the ']'
+				action = first + first[open].arg;
+			}
+			BF_NEXT
+		}
+#ifdef BF_THREADED
+done:
+#else
+		}
+	}
+#endif
+	pointer = cell;
+	return true;
+}
+
+#undef BF_DISPATCH
+#undef BF_INSTRUCTION
+#undef BF_NEXT
+
+//Run the compiled instructions on the tape from the given cell and return the last pointed cell
+//The tape gives the first cell with begin(), checks the pointer after a move
+//with moved(), gives the cell at an offset of the pointer with at(), makes
+//the cells up to an offset exist with reserve() and runs the scan loops with
+//scan(), its checked constant tells if the loops after a RESERVE can skip
+//these checks
+//The monitor is told of each instruction run with count(), of each iteration
+//of a loop with iteration(), given its '[', and of each new iteration with
+//back_edge(), given the length of the loop, which stops the run when it
+//returns false
+//The run starts at the instruction next, which is set to the instruction to
+//continue from when the monitor or an interrupted read stopped the run, or to
+//the end of the code
+template<class Tape, class Monitor>
+size_t execute(Tape& tape, size_t const& position, std::vector<Instruction> const& code,
+			   BFInput& in, BFOutput& out, Monitor& monitor, size_t& next) {
+	typename Tape::cell_type* cell = tape.begin() + position;
+	if (execute_range(tape, cell, code.data(), next, code.size(), in, out, monitor, next)) next = code.size();
+	return cell - tape.begin();
+}
+
+template<class Tape, class Monitor>
+size_t execute(Tape& tape, size_t const& position, std::vector<Instruction> const& code,
+			   BFInput& in, BFOutput& out, Monitor& monitor) {
+	size_t next(0);
+	return execute(tape, position, code, in, out, monitor, next);
+}
+
+//Monitor doing nothing, the execution loop is compiled as if there was none
+struct NoMonitor {
+	void count(size_t const&) throw() {}
+
+	void iteration(size_t const&) throw() {}
+
+	bool back_edge(unsigned long long const&) throw() {
+		return true;
+	}
+};
+
+template<class Tape>
+size_t execute(Tape& tape, size_t const& position, std::vector<Instruction> const& code,
+			   BFInput& in, BFOutput& out) {
+	NoMonitor monitor;
+	return execute(tape, position, code, in, out, monitor);
+}
+
+#endif
@@ -3,10 +3,16 @@
 
 #include <iostream>
 #include <string>
-#include <stack>
 #include <vector>
 #include <set>
 #include <map>
+#include <memory>
+#include <streambuf>
+#include "batch.h"
+#include "io.h"
+#include "program.h"
+#include "source.h"
+#include "tape.h"
 
 //Flag used to know how to run the interpreter
 //Could be use later for state and other
@@ -16,20 +22,52 @@ class BFInterpreter
 {
 private:
 	std::string m_code;
+	//File whose code is compiled directly instead of being copied in m_code
+	std::unique_ptr<BFSource> m_source;
 	std::istream* m_in;
 	std::ostream* m_out;
-
+	//Stream of the console putting each byte written by the program on its own line
+	std::unique_ptr<std::streambuf> m_console_buffer;
+	std::unique_ptr<std::ostream> m_console_out;
+	//Buffered I/O of the brainfuck program on top of m_in and m_out
+	std::unique_ptr<BFInput> m_input;
+	std::unique_ptr<BFOutput> m_output;
+	bool m_interactive = false;
+
+	//Code of the console compiled as it is entered and the instruction to run next
+	BFProgram m_console_program;
 	size_t m_current_action;
-	std::stack<size_t> m_loop_stack;
-	size_t m_current_cell;
-	std::vector<char> m_cell_vector;
-	int m_in_loop = 0;
-	int m_wait_for_end_loop = 0;
+	std::unique_ptr<BFTape> m_tape;
+	TapeKind m_tape_kind;
+	size_t m_tape_size = 0;
+	bool m_negative_cells = false;
+	unsigned int m_cell_bits = 8;
 
 	bool m_running_console = false;
 	std::string m_prompt;
 
 	Flag m_flag;
+	Optimization m_optimization;
+	bool m_jit = false;
+	bool m_parallel = false;
+	std::string m_translation_path;
+	//The file mode runs the code once for each input of the batch
+	bool m_batch = false;
+	BatchOptions m_batch_options;
+	//Where the profile of the run is written when it is not empty
+	std::string m_profile_path;
+	BFLimits m_limits;
+	std::unique_ptr<BFBudget> m_budget;
+	//Where the state of the run is saved on SIGTERM and every period seconds when it is not 0
+	std::string m_checkpoint_path;
+	double m_checkpoint_period = 0;
+	std::string m_resume_path;
+	//Directory keeping the compiled programs when it is not empty
+	std::string m_cache_path;
+	//Where the metrics of the run are written when it is not empty
+	std::string m_metrics_path;
+	//Time taken to read the source of the file
+	double m_load_seconds = 0;
 
 	static const std::string CONSOLE_HELP;
 
@@ -54,7 +92,71 @@ public:
 	void set_file() throw();
 	bool file() const throw();
 
+	void set_optimization(Optimization const& optimization) throw();
+	Optimization optimization() const throw();
+
+	void set_jit(bool const& jit) throw();
+	bool jit() const throw();
+
+	//The independent loops of the file run on threads, experimental, the code
+	//is interpreted and only a vector tape without limits runs them so
+	void set_parallel(bool const& parallel) throw();
+	bool parallel() const throw();
+
+	//An interactive program writes each byte right away, the console always is
+	void set_interactive(bool const& interactive) throw();
+	bool interactive() const throw();
+
+	//A size of 0 uses the default size of the kind of tape
+	void set_tape(TapeKind const& kind, size_t const& size = 0) throw();
+	TapeKind tape_kind() const throw();
+	//The pointer can go left of the first cell, only on a paged tape
+	void set_negative_cells(bool const& negative) throw();
+	bool negative_cells() const throw();
+
+	//Width of the cells in bits, 8, 16 or 32
+	void set_cell_bits(unsigned int const& bits);
+	unsigned int cell_bits() const throw();
+
+	//The tape and the width of the cells are the ones of the interpreter
+	void set_batch(BatchOptions const& options);
+	bool batch() const throw();
+
+	//Count the instructions run by the file and write a report at the path and
+	//the folded stacks of the loops at the path followed by '.folded'
+	//The profiled code is always interpreted
+	void set_profile(std::string const& path) throw();
+	std::string const& profile() const throw();
+
+	//Caps on the instructions run and the time taken by the file, a profiled run has none
+	void set_limits(BFLimits const& limits) throw();
+	BFLimits const& limits() const throw();
+
+	//Save the state of the file being run on SIGTERM, which ends the run, and
+	//every period seconds when it is not 0, the code is always interpreted
+	void set_checkpoint(std::string const& path, double const& period = 0) throw();
+	std::string const& checkpoint() const throw();
+	//Continue the run saved in the checkpoint, the program is given the same input
+	//again and what it already read is skipped, its output goes on after what it wrote
+	void set_resume(std::string const& path) throw();
+	std::string const& resume() const throw();
+
+	//The compiled code is kept in the directory and read from it by the next
+	//runs of the same code with the same optimizations
+	void set_cache(std::string const& directory) throw();
+	std::string const& cache() const throw();
+
+	//Write the metrics of the file as JSON at the end of its run and each time
+	//SIGUSR1 is received, the code is always interpreted
+	void set_metrics(std::string const& path) throw();
+	std::string const& metrics() const throw();
+
+	void set_translation(std::string const& path);
+	std::string const& translation() const throw();
+
 	void set_code(std::string const& code) throw();
+	//Run the code of a file, it is compiled without being kept as a string
+	void set_source(std::string const& path);
 	bool is_usable_code(std::string const& code) const throw();
 
 	inline static bool is_valid_brainfuck_char(char const& c) throw();
@@ -63,42 +165,36 @@ public:
 
 private:
 
-	//---BRAINFUCK BASIC ACTION---
-
-	void start_loop() throw();
-	void end_loop() throw();
-	void plus() throw();
-	void minus() throw();
-	void left() throw();
-	void right() throw();
-	void input() throw();
-	void output() throw();
-
-	void execute_action(char const& action) throw();
-
 	//---HELPING METHODS---
 
-	void run_code_part(int start = 0) throw();
-	void run_file(int start = 0) throw();
-	void run_console() throw();
+	void run_console_code();
+	BFProgram compile() const;
+	void run_file();
+	void run_batch_file() const;
+	void run_checkpointed(BFProgram const& program);
+	void run_metered(BFProgram const& program, double const& compile_seconds);
+	void write_profile(BFProgram const& program, BFProfile const& profile) const;
+	void translate() const;
+	void run_console();
 
-	void initialize() throw();
+	void initialize();
 
 	void read_string(std::string const& code) throw();
 	void add_char(char const& new_char) throw();
+	void clear_code() throw();
 
 	//---COMMAND METHOD---
 
-	void process_console_input(std::vector<std::string>& args) throw();
+	void process_console_input(std::vector<std::string>& args);
 
 	void command_help() const throw();
-	void command_end() throw();
+	void command_end();
 	void command_cell(std::vector<std::string> const& Flag) const;
 	void command_code() const throw();
 	void command_exit() throw();
 	void command_prompt(std::vector<std::string> const& args);
 
-	void read_console_brainfuck(std::string const& input) throw();
+	void read_console_brainfuck(std::string const& input);
 };
 
 #endif
@@ -0,0 +1,113 @@
+#ifndef BRAINFUCKCONSOLE_SRC_IO_H_
+#define BRAINFUCKCONSOLE_SRC_IO_H_
+
+#include <iostream>
+#include <vector>
+
+//Bytes written by '.', kept in a large buffer written at once on a file
+//descriptor or in a stream, or written straight into a memory span
+//An interactive output is written after every byte
+class BFOutput
+{
+private:
+	std::ostream* m_stream;
+	int m_fd;
+	std::vector<char> m_buffer;
+	//Where the bytes are put, the buffer or the span
+	char* m_first;
+	char* m_next;
+	//The bytes are written when m_next reaches it
+	char* m_limit;
+	size_t m_written;
+	bool m_span;
+	bool m_interactive;
+	bool m_failed;
+	//Receives the bytes that don't fit in a full span
+	char m_discard[64];
+
+public:
+	static const size_t BUFFER_SIZE;
+
+	explicit BFOutput(int const& fd, bool const& interactive = false);
+	explicit BFOutput(std::ostream& out, bool const& interactive = false);
+	//Nothing is allocated, the output fails if it doesn't fit in the span
+	BFOutput(char* span, size_t const& capacity);
+	~BFOutput();
+
+	BFOutput(BFOutput const&) = delete;
+	BFOutput& operator=(BFOutput const&) = delete;
+
+	void put(char const& c) {
+		*m_next++ = c;
+		if (m_next == m_limit) flush();
+	}
+
+	void write(char const* data, size_t const& size) {
+		for (size_t i(0); i != size; ++i)
+			put(data[i]);
+	}
+
+	//Write the buffered bytes, an error is kept for fail()
+	void flush() throw();
+	bool fail() const throw();
+	//Number of bytes put so far
+	size_t count() const throw();
+};
+
+//Bytes read by ',', read by large blocks from a file descriptor or from
+//what a stream already has in its buffer, or read in place from a memory span
+//An interactive input only takes the bytes it uses from a stream, so that
+//the stream can still be read by others
+class BFInput
+{
+private:
+	std::istream* m_stream;
+	int m_fd;
+	bool m_interactive;
+	std::vector<char> m_buffer;
+	//Block of input being read
+	char const* m_first;
+	char const* m_next;
+	char const* m_end;
+	//Bytes of the previous blocks
+	size_t m_before;
+	BFOutput* m_tied;
+	//Tells if a read interrupted by a signal must stop
+	bool (*m_interruption)();
+	bool m_interrupted;
+
+public:
+	static const size_t BUFFER_SIZE;
+
+	explicit BFInput(int const& fd, bool const& interactive = false);
+	explicit BFInput(std::istream& in, bool const& interactive = false);
+	//Nothing is allocated, the span is the whole input
+	BFInput(char const* span, size_t const& size);
+
+	BFInput(BFInput const&) = delete;
+	BFInput& operator=(BFInput const&) = delete;
+
+	//The output is flushed before waiting for more input
+	void tie(BFOutput* out) throw();
+
+	//A read interrupted by a signal stops when the function returns true, get()
+	//then returns false and interrupted() is true, nullptr always reads again
+	void set_interruption(bool (*interruption)()) throw();
+	//The last get() returned false because of a signal, not at the end of the input
+	bool interrupted() const throw();
+
+	//Number of bytes taken so far
+	size_t count() const throw();
+
+	//Return false at the end of the input
+	bool get(char& c) {
+		if (m_next == m_end && !refill()) return false;
+		c = *m_next++;
+		return true;
+	}
+
+private:
+	bool refill();
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef BRAINFUCKCONSOLE_SRC_JIT_H_
+#define BRAINFUCKCONSOLE_SRC_JIT_H_
+
+#include <csetjmp>
+#include <exception>
+#include <vector>
+#include "budget.h"
+#include "io.h"
+#include "program.h"
+
+//Compiled program translated to x86-64 machine code in an executable buffer
+//The generated code keeps the pointer in a register and only calls back
+//to C++ for '.', ',' and, when it is checked, when the pointer leaves the allocated tape
+class BFJit
+{
+public:
+	//State shared by the generated code and its callbacks
+	struct Context {
+		unsigned char* begin;
+		unsigned char* end;
+		std::vector<unsigned char>* cells;
+		BFInput* in;
+		BFOutput* out;
+		long bad_cell;
+		//Countdown of the allowance of the budget, spent at the back-edges
+		unsigned long long left;
+		BFBudget* budget;
+		//Pointer when the budget stopped the run
+		unsigned char* stopped;
+		//Exception thrown by a callback, it can't go through the generated code
+		std::exception_ptr failure;
+		std::jmp_buf error;
+	};
+
+private:
+	unsigned char* m_code;
+	size_t m_size;
+	bool m_checked;
+	bool m_limited;
+	size_t m_reach;
+
+public:
+	static bool supported() throw();
+
+	//Limited code spends a budget at the back-edges of its loops
+	explicit BFJit(BFProgram const& program, bool const& checked = true, bool const& limited = false);
+	~BFJit();
+
+	BFJit(BFJit const&) = delete;
+	BFJit& operator=(BFJit const&) = delete;
+
+	//Checked code grows a vector tape, unchecked code runs on a guarded tape
+	bool checked() const throw();
+	bool limited() const throw();
+	//Reach of the compiled program
+	size_t reach() const throw();
+
+	//Run the checked code on the tape from the given cell, return the cell pointed at the end
+	//Limited code stops when the budget is spent, it runs without limits when there is none
+	size_t run(std::vector<unsigned char>& cells, size_t cell, BFOutput& out, BFInput& in, BFBudget* budget = nullptr) const;
+	//Run the unchecked code from the given cell, return the pointer at the end
+	unsigned char* run(unsigned char* cell, BFOutput& out, BFInput& in, BFBudget* budget = nullptr) const;
+};
+
+#endif
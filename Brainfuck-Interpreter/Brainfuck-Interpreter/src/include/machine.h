@@ -0,0 +1,55 @@
+#ifndef BRAINFUCKCONSOLE_SRC_MACHINE_H_
+#define BRAINFUCKCONSOLE_SRC_MACHINE_H_
+
+#include <memory>
+#include "budget.h"
+#include "io.h"
+#include "jit.h"
+#include "program.h"
+#include "tape.h"
+
+//Tape on which compiled programs are run
+//A BFProgram or a BFJit is never changed by a run so any number of machines
+//can run the same one at once, a machine is used by one thread at a time
+//and keeps its memory from a run to the next
+class BFMachine
+{
+private:
+	std::unique_ptr<BFTape> m_tape;
+	std::unique_ptr<BFBudget> m_budget;
+	BFPrefix const* m_prefix;
+
+public:
+	//A size of 0 is the default size of the kind of tape, only a paged tape can have negative cells
+	explicit BFMachine(TapeKind const& kind = TapeKind::vector, size_t const& size = 0, unsigned int const& cell_bits = 8,
+					   bool const& negative_cells = false);
+
+	//Run the program on a cleared tape, the input is read from a span and the
+	//output written in another one
+	//Return the size of the output, throw output_overflow if it doesn't fit
+	size_t run(BFProgram const& program, char const* input, size_t const& input_size, char* output, size_t const& capacity);
+	//The native code is checked for a vector tape and unchecked for the guarded
+	//ones, it doesn't run on a paged tape
+	size_t run(BFJit const& jit, char const* input, size_t const& input_size, char* output, size_t const& capacity);
+
+	void run(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFJit const& jit, BFInput& in, BFOutput& out);
+
+	//Each run gets the whole budget and throws limit_exceeded when it is spent,
+	//the native code must be limited
+	void set_limits(BFLimits const& limits);
+
+	//Each run starts from the state left by the prefix, which must fit on the
+	//tape, and writes its output first, the code run is then the rest of the
+	//program, nullptr starts from a cleared tape
+	void set_prefix(BFPrefix const* prefix) throw();
+
+	//State of the tape at the end of the last run
+	BFTape const& tape() const throw();
+
+private:
+	//Clear the tape or put it in the state of the prefix
+	void start(BFOutput& out);
+};
+
+#endif
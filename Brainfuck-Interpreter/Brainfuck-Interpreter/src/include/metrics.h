@@ -0,0 +1,86 @@
+#ifndef BRAINFUCKCONSOLE_SRC_METRICS_H_
+#define BRAINFUCKCONSOLE_SRC_METRICS_H_
+
+#include <csignal>
+#include <iostream>
+#include <vector>
+#include "budget.h"
+#include "program.h"
+
+//Monitor counting what a run does, only the iterations of the loops update the
+//counters, each one counts the instructions run directly in its loop, the
+//instructions outside of the loops are counted up to the last outermost loop
+//entered
+//It stops the run at its next back-edge once the metrics are asked by
+//SIGUSR1, or when the budget given is spent
+class BFMetrics
+{
+private:
+	static volatile std::sig_atomic_t s_requested;
+
+	//Instructions run by an iteration of the loop of each '[', its nested loops
+	//count as their '['
+	std::vector<unsigned long long> m_loop_instructions;
+	//Instructions outside of the loops before each instruction
+	std::vector<unsigned long long> m_outside_instructions;
+	unsigned long long m_instructions;
+	unsigned long long m_outside;
+	unsigned long long m_iterations;
+	BFBudget* m_budget;
+
+public:
+	//nullptr counts without limits
+	explicit BFMetrics(BFProgram const& program, BFBudget* budget = nullptr);
+
+	//Ask for the metrics on SIGUSR1
+	static void install();
+	static void uninstall();
+	//Forget the request once its metrics are written
+	static void clear() throw();
+	//The metrics were asked, it stops the reads waiting for input
+	static bool requested() throw();
+
+	void count(size_t const&) throw() {}
+
+	void iteration(size_t const& open) throw() {
+		m_instructions += m_loop_instructions[open];
+		m_outside = m_outside_instructions[open + 1];
+		++m_iterations;
+	}
+
+	bool back_edge(unsigned long long const& instructions) {
+		if (m_budget && !m_budget->back_edge(instructions)) return false;
+		return s_requested == 0;
+	}
+
+	//The run got to the instruction, all the instructions outside of the loops
+	//before it have run
+	void reached(size_t const& instruction) throw();
+
+	unsigned long long instructions() const throw();
+	unsigned long long iterations() const throw();
+
+private:
+	static void on_signal(int signal);
+};
+
+//State of a run, written as one JSON object
+struct BFMetricsReport {
+	//The run goes on, the metrics were asked by SIGUSR1
+	bool running = false;
+	unsigned long long instructions = 0;
+	unsigned long long iterations = 0;
+	//Bytes read and written by the program
+	unsigned long long input = 0;
+	unsigned long long output = 0;
+	//Cells of the tape reached so far
+	unsigned long long cells = 0;
+	//Time spent reading the source, compiling it and running it
+	double load_seconds = 0;
+	double compile_seconds = 0;
+	double execute_seconds = 0;
+};
+
+void write_metrics(std::ostream& out, BFMetricsReport const& report);
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef BRAINFUCKCONSOLE_SRC_PARALLEL_H_
+#define BRAINFUCKCONSOLE_SRC_PARALLEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "analysis.h"
+#include "executor.h"
+
+//Run the loops of the group on threads, each one on its own slice of the
+//cells, which all exist, from the pointer where the group starts
+//Nothing is merged, the slices are the cells of the tape
+template<class Tape>
+void run_loop_group(Tape& tape, typename Tape::cell_type* cell, std::vector<Instruction> const& code,
+					BFLoopGroup const& group, BFInput& in, BFOutput& out) {
+	std::atomic<size_t> taken(0);
+	auto work = [&]() {
+		UncheckedTape<Tape> unchecked(tape);
+		NoMonitor monitor;
+		size_t next(0);
+		for (size_t loop; (loop = taken++) < group.loops.size();) {
+			BFRegion const& region = group.loops[loop];
+			typename Tape::cell_type* pointer = cell + region.shift;
+			execute_range(unchecked, pointer, code.data(), region.first, region.last + 1, in, out, monitor, next);
+		}
+	};
+	size_t const workers = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), group.loops.size());
+	std::vector<std::thread> threads;
+	for (size_t i(1); i < workers; ++i) {
+		try {
+			threads.emplace_back(work);
+		}
+		catch (std::system_error const&) {
+			//The threads already started and this one take the other loops
+			break;
+		}
+	}
+	work();
+	for (std::thread& thread : threads)
+		thread.join();
+}
+
+//Run the compiled instructions on the tape like execute, the groups of
+//independent loops run on threads, the rest of the code runs alone
+//A group whose lowest cell doesn't exist runs alone too, so that the program
+//stops on the same move
+template<class Tape>
+size_t execute_parallel(Tape& tape, size_t const& position, std::vector<Instruction> const& code,
+						std::vector<BFLoopGroup> const& groups, BFInput& in, BFOutput& out) {
+	typename Tape::cell_type* cell = tape.begin() + position;
+	NoMonitor monitor;
+	size_t next(0);
+	size_t done(0);
+	for (BFLoopGroup const& group : groups) {
+		execute_range(tape, cell, code.data(), done, group.begin, in, out, monitor, next);
+		done = group.begin;
+		if (group.bounds.highest > INT_MAX || (Tape::checked && cell - tape.begin() < -group.bounds.lowest)) continue;
+		cell = tape.reserve(cell, static_cast<int>(group.bounds.highest));
+		run_loop_group(tape, cell, code, group, in, out);
+		cell += group.bounds.shift;
+		done = group.end;
+	}
+	execute_range(tape, cell, code.data(), done, code.size(), in, out, monitor, next);
+	return cell - tape.begin();
+}
+
+#endif
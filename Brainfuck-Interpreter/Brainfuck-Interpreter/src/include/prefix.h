@@ -0,0 +1,32 @@
+#ifndef BRAINFUCKCONSOLE_SRC_PREFIX_H_
+#define BRAINFUCKCONSOLE_SRC_PREFIX_H_
+
+#include "program.h"
+#include "tape.h"
+
+//Instructions the prefix may run, counted like a budget, time it may take,
+//bytes it may write and cells it may use
+extern const unsigned long long PREFIX_INSTRUCTIONS;
+extern const double PREFIX_SECONDS;
+extern const size_t PREFIX_OUTPUT;
+extern const size_t PREFIX_CELLS;
+
+//Run the start of the program that reads no input on a tape of PREFIX_CELLS
+//cells of the width and keep the state it leaves
+//The program is run by its outermost loops, up to the first one reading input,
+//and stops before the loop that goes past the instructions, the time or the
+//output allowed or leaves the tape, the rest of the program starts after the last
+//loop run, so that it never starts inside a loop
+BFPrefix evaluate_prefix(BFProgram const& program, unsigned int const& cell_bits,
+						 unsigned long long const& instructions = PREFIX_INSTRUCTIONS);
+
+//Program made of the instructions following the prefix of the program, it
+//starts from the state of the prefix
+BFProgram rest_of_prefix(BFProgram const& program);
+
+//Put the cleared tape in the state left by the prefix, its output is not written
+//Return false when the tape can't hold the cells the prefix reached, it is
+//then cleared and the whole program must be run instead
+bool restore_prefix(BFPrefix const& prefix, BFTape& tape);
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef BRAINFUCKCONSOLE_SRC_PROFILE_H_
+#define BRAINFUCKCONSOLE_SRC_PROFILE_H_
+
+#include <iostream>
+#include <vector>
+#include "program.h"
+
+//Number of executions of each instruction of a compiled program
+//The loops are measured from their brackets: the '[' runs once each time the
+//loop is entered and the ']' once at the end of each iteration
+class BFProfile
+{
+private:
+	std::vector<unsigned long long> m_counts;
+
+public:
+	explicit BFProfile(BFProgram const& program);
+
+	void count(size_t const& instruction) {
+		++m_counts[instruction];
+	}
+
+	void iteration(size_t const&) throw() {}
+
+	bool back_edge(unsigned long long const&) throw() {
+		return true;
+	}
+
+	std::vector<unsigned long long> const& counts() const throw();
+	unsigned long long total() const throw();
+
+	//The source in [first, last) is the one the program was compiled from,
+	//it gives the line and column of the instructions
+
+	//Instructions sorted by number of executions, then loops sorted by number
+	//of instructions run inside them
+	void write_report(std::ostream& out, BFProgram const& program, char const* first, char const* last) const;
+	//One line per loop with the nested loops as frames and the instructions
+	//run directly in the loop as weight, the input of flamegraph.pl
+	void write_folded(std::ostream& out, BFProgram const& program, char const* first, char const* last) const;
+};
+
+#endif
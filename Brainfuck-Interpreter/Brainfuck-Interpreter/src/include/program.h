@@ -0,0 +1,140 @@
+#ifndef BRAINFUCKCONSOLE_SRC_PROGRAM_H_
+#define BRAINFUCKCONSOLE_SRC_PROGRAM_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+//Operation executed by one instruction of a compiled program
+enum class OpCode : unsigned char {
+	ADD,	//Add arg to the cell at offset of the pointer
+	MOVE,	//Move the pointer of arg cells
+	OPEN,	//If the pointed cell is zero jump after the instruction arg
+	CLOSE,	//If the pointed cell is not zero jump after the instruction arg
+	INPUT,	//Read into the cell at offset of the pointer
+	OUTPUT,	//Write the cell at offset of the pointer
+	CLEAR,	//Set the cell at offset of the pointer to zero
+	SCAN,	//Move the pointer of arg cells until it points to a zero cell
+	MUL,	//Add arg times the pointed cell to the cell at offset
+	RESERVE	//Make the cells from arg to offset of the pointer exist, the loop
+			//after it stays in them and runs without checking the pointer
+};
+
+struct Instruction {
+	OpCode op;
+	int arg;
+	int offset;
+};
+
+//Cells used by a part of a program, relative to the pointer where it starts
+struct BFBounds {
+	//The cells used are known, the part always ends with the pointer moved of shift
+	bool bounded;
+	long lowest;
+	long highest;
+	long shift;
+};
+
+//Optimizations the compiler is allowed to do, used as bitflag
+enum class Optimization {
+	none = 0x00,
+	fold = 0x01,		//Fold the runs of '+'/'-' and '<'/'>'
+	clear = 0x02,		//'[-]' sets the cell to zero
+	scan = 0x04,		//'[>]' moves to the next zero cell
+	multiply = 0x08,	//'[->+>++<<]' adds multiples of the cell to other cells
+	bounds = 0x10,		//Balanced loops reserve their cells once and run without checks
+	offsets = 0x20,		//'>+>++<<' adds to cells at offsets of the pointer, which only moves before the brackets
+	prefix = 0x40,		//The start of the program reading no input is run once, the next runs start from its state
+	all = 0x7f
+};
+
+inline Optimization operator|(Optimization const& a, Optimization const& b) throw() {
+	return Optimization(static_cast<int>(a) | static_cast<int>(b));
+}
+
+inline bool operator&(Optimization const& a, Optimization const& b) throw() {
+	return (static_cast<int>(a) & static_cast<int>(b)) != 0;
+}
+
+//State left by the start of a program that reads no input, the runs of the
+//program can start from it instead of running that start again
+struct BFPrefix {
+	//Instruction the rest of the program starts from, 0 when there is no prefix
+	size_t instruction = 0;
+	//Width of the cells it was run on
+	unsigned int cell_bits = 0;
+	long position = 0;
+	//Number of cells from the first one that the prefix may have used
+	size_t reach = 0;
+	//Cells that are not zero and their value
+	std::vector<std::pair<long, unsigned long>> cells;
+	std::string output;
+};
+
+//True for the eight characters of brainfuck, the others are comments
+bool is_brainfuck_char(char const& c) throw();
+
+//Brainfuck code lowered to a compact instruction vector
+//Runs of '+'/'-' and '<'/'>' are folded and the brackets hold their jump target
+class BFProgram
+{
+private:
+	std::vector<Instruction> m_instructions;
+	//Place in the source of the first character of each instruction
+	std::vector<size_t> m_sources;
+	Optimization m_optimization;
+	//Index of the '[' waiting for their ']'
+	std::vector<size_t> m_open_loop;
+	//The instructions before it were compiled by a previous append and are never changed
+	size_t m_fold_barrier;
+	//Number of characters compiled so far, the place of the next one in the source
+	size_t m_source_size;
+	BFBounds m_bounds;
+	BFPrefix m_prefix;
+
+public:
+	BFProgram();
+	explicit BFProgram(std::string const& code, Optimization const& optimization = Optimization::all);
+	//Compile the source in [first, last), its comments are skipped
+	BFProgram(char const* first, char const* last, Optimization const& optimization = Optimization::all);
+	//Program compiled before from a source of source_size characters, as given
+	//by instructions(), sources() and bounds()
+	BFProgram(std::vector<Instruction> const& instructions, std::vector<size_t> const& sources,
+			  Optimization const& optimization, BFBounds const& bounds, size_t const& source_size);
+
+	void compile(std::string const& code);
+	void compile(char const* first, char const* last);
+	//Add the code at the end of the program, its '[' may wait for a ']' given
+	//by a later code, meanwhile they jump to the end of the program
+	//The instructions already compiled are not changed, except the jumps of the
+	//open '[', so that a run of the program can go on with the new code
+	void append(char const* first, char const* last);
+	//Index of the '[' waiting for their ']', the last one is the innermost
+	std::vector<size_t> const& open_loops() const throw();
+
+	Optimization optimization() const throw();
+	void set_optimization(Optimization const& optimization) throw();
+
+	std::vector<Instruction> const& instructions() const throw();
+	//An idiom replacing a loop is placed on the '[' of the loop
+	std::vector<size_t> const& sources() const throw();
+	//Cells used by the whole program, only known when the bounds were proved
+	//by a complete compilation
+	BFBounds const& bounds() const throw();
+	//Start of the program already run, see evaluate_prefix
+	BFPrefix const& prefix() const throw();
+	void set_prefix(BFPrefix const& prefix);
+	//Longest distance between the pointer and a cell used by one instruction
+	size_t reach() const throw();
+	size_t size() const throw();
+	bool empty() const throw();
+
+private:
+	void push(Instruction const& action, size_t const& source);
+	void fold(OpCode const& op, int const& arg, size_t const& source);
+	bool replace_loop(size_t const& open);
+	void offset_moves();
+	void reserve_loops();
+};
+
+#endif
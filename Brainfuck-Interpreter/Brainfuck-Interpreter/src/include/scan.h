@@ -0,0 +1,24 @@
+#ifndef BRAINFUCKCONSOLE_SRC_SCAN_H_
+#define BRAINFUCKCONSOLE_SRC_SCAN_H_
+
+#include <cstddef>
+
+//Search of the zero cell ending a scan loop like '[>]' or '[<<<]', going from
+//the cell by a stride of cells, the cells are compared by whole vectors
+//(SSE2 or AVX2, chosen when the program starts) when the stride is short
+//Only the cells from first to last, excluded, are read
+//Return the index from first of the zero cell, or of the first position out
+//of the cells when none is zero
+long find_zero_bytes(char const* first, char const* last, long const& cell, long const& stride, size_t const& width);
+
+//Pointer on the zero cell ending the scan from the cell, which is in [first, last),
+//or on the first position out of it when none is zero
+template<typename Cell>
+Cell* find_zero(Cell* cell, int const& stride, Cell* first, Cell* last) {
+	//The scan often has nothing to do
+	if (*cell == 0) return cell;
+	char const* bytes = reinterpret_cast<char const*>(first);
+	return first + find_zero_bytes(bytes, reinterpret_cast<char const*>(last), cell - first, stride, sizeof(Cell));
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef BRAINFUCKCONSOLE_SRC_SOURCE_H_
+#define BRAINFUCKCONSOLE_SRC_SOURCE_H_
+
+#include <string>
+#include <vector>
+
+//Content of a source file, mapped in memory so that it is compiled without
+//being copied, the files that can't be mapped, like pipes, are read instead
+class BFSource
+{
+private:
+	void* m_mapping;
+	size_t m_size;
+	std::vector<char> m_content;
+
+public:
+	explicit BFSource(std::string const& path);
+	~BFSource();
+
+	BFSource(BFSource const&) = delete;
+	BFSource& operator=(BFSource const&) = delete;
+
+	char const* begin() const throw();
+	char const* end() const throw();
+	size_t size() const throw();
+};
+
+#endif
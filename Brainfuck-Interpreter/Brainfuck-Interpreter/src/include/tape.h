@@ -0,0 +1,361 @@
+#ifndef BRAINFUCKCONSOLE_SRC_TAPE_H_
+#define BRAINFUCKCONSOLE_SRC_TAPE_H_
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "budget.h"
+#include "checkpoint.h"
+#include "io.h"
+#include "jit.h"
+#include "metrics.h"
+#include "profile.h"
+#include "program.h"
+#include "scan.h"
+
+//Monitor keeping the last instruction run, the console finds with it the '['
+//waiting for its ']' that skipped the end of the program
+struct BFLastInstruction {
+	size_t instruction;
+
+	void count(size_t const& i) throw() {
+		instruction = i;
+	}
+
+	void iteration(size_t const&) throw() {}
+
+	bool back_edge(unsigned long long const&) throw() {
+		return true;
+	}
+};
+
+//Way the cells of the tape are stored
+enum class TapeKind { vector, fixed, mmap, paged };
+
+//Cells of the interpreter and the pointer on them
+//The compiled programs are run by the tape so that the execution loop is
+//specialized for the way the cells are stored and for their width
+class BFTape
+{
+protected:
+	long m_position;
+	BFBudget* m_budget;
+
+public:
+	BFTape();
+	virtual ~BFTape();
+
+	//Only a paged tape with negative cells has cells below 0
+	long position() const throw();
+
+	//The next runs are stopped with limit_exceeded when the budget is spent,
+	//the tape is kept as it was, nullptr runs without limits
+	//Native code must have been compiled limited, a profiled run has no limits
+	void set_budget(BFBudget* budget) throw();
+
+	//Number of cells that can be shown, the following cells have never been used
+	virtual size_t size() const throw() = 0;
+	//Number of cells the pointer and the instructions reached since the tape
+	//was cleared, at least, the tapes may count whole pages
+	virtual size_t reached() const;
+	virtual unsigned long value(long const& cell) const = 0;
+	//Ranges [first, last) of the cells that exist, in order, the other cells are zero
+	virtual std::vector<std::pair<long, long>> ranges() const;
+	bool exists(long const& cell) const;
+	//Number of cells from the first one to the last one that may not be zero
+	virtual size_t extent() const = 0;
+	//Used to restore a checkpoint
+	virtual void set_value(long const& cell, unsigned long const& value) = 0;
+	virtual void seek(long const& cell) = 0;
+
+	//Set every cell to zero and the pointer on the first one, the memory is kept
+	virtual void clear() = 0;
+
+	virtual void run(BFProgram const& program, BFInput& in, BFOutput& out) = 0;
+	//Count the instructions run in the profile
+	virtual void run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile) = 0;
+	//Run from the instruction until the end or until a checkpoint is asked,
+	//return the instruction to continue from, the size of the program at the end
+	virtual size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+					   BFCheckpointTrigger& trigger) = 0;
+	//Run from the instruction until the end, return the size of the program
+	//The last instruction run is kept by the monitor
+	virtual size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+					   BFLastInstruction& last) = 0;
+	//Run from the instruction until the end or until the metrics stop it,
+	//return the instruction to continue from, the size of the program at the end
+	virtual size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+					   BFMetrics& metrics) = 0;
+	//Compile the program to native code when it is available for the tape and run it
+	virtual void run_native(BFProgram const& program, BFInput& in, BFOutput& out) = 0;
+	//Run the groups of independent loops of the program on threads, only a
+	//vector tape does, the other tapes and the runs with a budget run it alone
+	virtual void run_parallel(BFProgram const& program, BFInput& in, BFOutput& out);
+	//Only tapes of 8 bits cells run native code
+	virtual void run(BFJit const& jit, BFInput& in, BFOutput& out) = 0;
+
+protected:
+	//Throw limit_exceeded if the budget stopped the last run
+	void check_budget() const;
+};
+
+//Create a tape of the given kind, size and cell width in bits (8, 16 or 32)
+//A size of 0 is the default size of the kind of tape, only a paged tape can
+//have negative cells
+BFTape* create_tape(TapeKind const& kind, size_t const& size, unsigned int const& cell_bits,
+					bool const& negative_cells = false);
+
+//Tape growing on the right when the pointer goes past its end
+template<typename Cell>
+class VectorTape : public BFTape
+{
+public:
+	typedef Cell cell_type;
+	static const bool checked = true;
+
+private:
+	std::vector<cell_type> m_cells;
+
+public:
+	VectorTape();
+
+	size_t size() const throw();
+	unsigned long value(long const& cell) const;
+	size_t extent() const;
+	void set_value(long const& cell, unsigned long const& value);
+	void seek(long const& cell);
+
+	void clear();
+
+	void run(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFCheckpointTrigger& trigger);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFLastInstruction& last);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFMetrics& metrics);
+	void run_native(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run_parallel(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFJit const& jit, BFInput& in, BFOutput& out);
+
+	//---EXECUTION POLICY---
+
+	cell_type* begin() throw() {
+		return m_cells.data();
+	}
+
+	//Check the pointer after a move
+	cell_type* moved(cell_type* cell) {
+		return reserve(cell, 0);
+	}
+
+	//Make the cell at offset of the pointer exist, return the pointer
+	cell_type* reserve(cell_type* cell, int const& offset) {
+		if (static_cast<size_t>(cell - m_cells.data() + offset) >= m_cells.size()) return grow(cell, offset);
+		return cell;
+	}
+
+	//Cell at offset of the pointer, which is kept valid
+	cell_type& at(cell_type*& cell, int const& offset) {
+		cell = reserve(cell, offset);
+		return cell[offset];
+	}
+
+	//Move by the stride until a zero cell, the cells past the end are zero
+	cell_type* scan(cell_type* cell, int const& stride) {
+		return moved(find_zero(cell, stride, m_cells.data(), m_cells.data() + m_cells.size()));
+	}
+
+private:
+	cell_type* grow(cell_type* cell, int const& offset);
+	//Make all the cells used by a program proved bounded exist, false when
+	//they are not known and the program must be checked
+	bool reserve_program(BFProgram const& program);
+};
+
+//Tape reserved with mmap between two inaccessible guard regions
+//The pointer moves without any check, a use of the guard regions is caught
+//and reported, only the pages actually used take memory
+template<typename Cell>
+class GuardedTape : public BFTape
+{
+public:
+	typedef Cell cell_type;
+	static const bool checked = false;
+	//Size of each guard region, no single move of a program may jump over it
+	static const size_t GUARD_SIZE;
+
+private:
+	char* m_mapping;
+	size_t m_mapping_size;
+	cell_type* m_cells;
+	size_t m_count;
+	//Last cell known to have been reached
+	size_t m_used;
+	bool m_populated;
+
+public:
+	GuardedTape(size_t const& count, bool const& populate);
+	~GuardedTape();
+
+	GuardedTape(GuardedTape const&) = delete;
+	GuardedTape& operator=(GuardedTape const&) = delete;
+
+	size_t size() const throw();
+	//Up to the last page in memory, a populated tape has all its pages in memory
+	//and only knows the last cell that is not zero
+	size_t reached() const;
+	unsigned long value(long const& cell) const;
+	size_t extent() const;
+	void set_value(long const& cell, unsigned long const& value);
+	void seek(long const& cell);
+
+	void clear();
+
+	void run(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFCheckpointTrigger& trigger);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFLastInstruction& last);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFMetrics& metrics);
+	void run_native(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFJit const& jit, BFInput& in, BFOutput& out);
+
+	//---EXECUTION POLICY---
+
+	cell_type* begin() throw() {
+		return m_cells;
+	}
+
+	cell_type* moved(cell_type* cell) throw() {
+		return cell;
+	}
+
+	cell_type* reserve(cell_type* cell, int const&) throw() {
+		return cell;
+	}
+
+	cell_type& at(cell_type*& cell, int const& offset) throw() {
+		return cell[offset];
+	}
+
+	//A scan leaving the cells goes on in the guard region, where it is caught
+	cell_type* scan(cell_type* cell, int const& stride) {
+		cell = find_zero(cell, stride, m_cells, m_cells + m_count);
+		while (*cell != 0) cell += stride;
+		return cell;
+	}
+
+private:
+	void check_reach(size_t const& reach) const;
+	void set_position(long const& position);
+	//Number of cells up to the last page in memory
+	size_t resident() const;
+};
+
+//Tape made of pages of cells allocated when the pointer first reaches them,
+//a program using cells far apart only takes the pages it uses
+//The pages come from a pool, a cleared tape keeps them for the next run
+//The page of the pointer is kept, the moves staying in it are checked like
+//on a vector tape
+template<typename Cell>
+class PagedTape : public BFTape
+{
+public:
+	typedef Cell cell_type;
+	//The cells used by a loop may be on several pages, it is always run with the checks
+	static const bool checked = false;
+	static const long PAGE_SIZE = 4096;
+	//Number of pages allocated at once by the pool
+	static const size_t BLOCK_SIZE = 16;
+
+private:
+	//Page of each number from m_first_page, nullptr when it doesn't exist
+	std::vector<cell_type*> m_pages;
+	long m_first_page;
+	//Page of the pointer during a run
+	cell_type* m_page;
+	long m_page_number;
+	bool m_negative;
+	std::vector<std::unique_ptr<cell_type[]>> m_blocks;
+	//Pages of the pool not in the tape, all their cells are zero
+	std::vector<cell_type*> m_free;
+
+public:
+	explicit PagedTape(bool const& negative);
+
+	size_t size() const throw();
+	//The cells of the pages created, on both sides of the cell 0
+	size_t reached() const;
+	unsigned long value(long const& cell) const;
+	std::vector<std::pair<long, long>> ranges() const;
+	size_t extent() const;
+	void set_value(long const& cell, unsigned long const& value);
+	void seek(long const& cell);
+
+	void clear();
+
+	void run(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFCheckpointTrigger& trigger);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFLastInstruction& last);
+	size_t run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+			   BFMetrics& metrics);
+	//The native code needs the cells in one block, the program is interpreted
+	void run_native(BFProgram const& program, BFInput& in, BFOutput& out);
+	void run(BFJit const& jit, BFInput& in, BFOutput& out);
+
+	//---EXECUTION POLICY---
+
+	//First cell of the page of the pointer
+	cell_type* begin() throw() {
+		return m_page;
+	}
+
+	cell_type* moved(cell_type* cell) {
+		if (static_cast<unsigned long>(cell - m_page) < static_cast<unsigned long>(PAGE_SIZE)) return cell;
+		return turn_page(cell);
+	}
+
+	cell_type* reserve(cell_type* cell, int const&) throw() {
+		return cell;
+	}
+
+	//The cell may be on another page than the pointer, which stays on its page
+	cell_type& at(cell_type*& cell, int const& offset) {
+		if (static_cast<unsigned long>(cell - m_page + offset) < static_cast<unsigned long>(PAGE_SIZE)) return cell[offset];
+		return *page_cell(index(cell) + offset, true);
+	}
+
+	cell_type* scan(cell_type* cell, int const& stride) {
+		for (;;) {
+			cell = find_zero(cell, stride, m_page, m_page + PAGE_SIZE);
+			if (static_cast<unsigned long>(cell - m_page) < static_cast<unsigned long>(PAGE_SIZE)) return cell;
+			cell = turn_page(cell);
+		}
+	}
+
+private:
+	long index(cell_type const* cell) const throw() {
+		return m_page_number * PAGE_SIZE + (cell - m_page);
+	}
+
+	//Put the pointer on the cell, which may be on another page
+	cell_type* turn_page(cell_type* cell);
+	//The cell of the index, nullptr when its page doesn't exist and is not created
+	cell_type* page_cell(long const& cell, bool const& create);
+	cell_type const* page_cell(long const& cell) const;
+	//Pointer on the cell of the position, whose page becomes the page of the pointer
+	cell_type* point(long const& position);
+	template<class Monitor>
+	size_t execute_from(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+						Monitor& monitor);
+};
+
+#endif
@@ -0,0 +1,18 @@
+#ifndef BRAINFUCKCONSOLE_SRC_TRANSLATOR_H_
+#define BRAINFUCKCONSOLE_SRC_TRANSLATOR_H_
+
+#include <iostream>
+#include <string>
+#include "program.h"
+
+//Write a C translation unit doing what the compiled program does with cells of the given width in bits
+void translate_to_c(std::ostream& os, BFProgram const& program, unsigned int const& cell_bits = 8);
+
+//Write x86-64 GAS assembly (AT&T syntax) doing what the compiled program does
+void translate_to_assembly(std::ostream& os, BFProgram const& program);
+
+//Choose the translation from the file extension, '.s' and '.S' are assembly, anything else is C
+//The assembly translation only has 8 bits cells
+void translate_to_file(std::string const& path, BFProgram const& program, unsigned int const& cell_bits = 8);
+
+#endif
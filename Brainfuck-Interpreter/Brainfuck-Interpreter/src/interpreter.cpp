@@ -2,13 +2,44 @@
 
 #include "utils.h"
 #include "bfexception.h"
+#include "cache.h"
+#include "checkpoint.h"
+#include "metrics.h"
+#include "prefix.h"
+#include "translator.h"
 #include <algorithm>
+#include <chrono>
+#include <fstream>
 #include <numeric>
 #include <sstream>
+#include <unistd.h>
 
 
+//Write a new line after each byte so that every output of the console
+//program is shown on its own line
+class LineBuffer : public std::streambuf
+{
+private:
+	std::ostream& m_out;
+
+public:
+	explicit LineBuffer(std::ostream& out) :
+		m_out(out) {};
+
+protected:
+	int_type overflow(int_type c) {
+		if (traits_type::eq_int_type(c, traits_type::eof())) return traits_type::not_eof(c);
+		m_out.put(traits_type::to_char_type(c)).put('\n');
+		return m_out ? c : traits_type::eof();
+	}
+
+	int sync() {
+		return m_out.flush() ? 0 : -1;
+	}
+};
+
 inline bool BFInterpreter::is_valid_brainfuck_char(char const& c) throw() {
-	return BFInterpreter::BF_CHAR.find(c) != BFInterpreter::BF_CHAR.end();
+	return is_brainfuck_char(c);
 }
 
 inline bool BFInterpreter::is_valid_console_input(std::string const& s) throw() {
@@ -44,8 +75,10 @@ inline Flag operator^(Flag const& a, Flag const& b) throw() {
 
 	//Create the Interpreter from a string
 BFInterpreter::BFInterpreter(std::string const& code, std::ostream& out, std::istream& in) :
+		m_tape_kind(TapeKind::vector),
 		m_prompt(":::"),
-		m_flag(Flag::empty) {
+		m_flag(Flag::empty),
+		m_optimization(Optimization::all) {
 		m_in = &in;
 		m_out = &out;
 		read_string(code);
@@ -65,7 +98,10 @@ BFInterpreter::BFInterpreter() :
 
 void BFInterpreter::run() {
 	if (m_flag == Flag::empty) throw std::runtime_error("Interpreter flag is not set\n");
-	if (m_flag & Flag::file) run_file();
+	//The code is written in another language instead of being run
+	if ((m_flag & Flag::file) && !m_translation_path.empty()) translate();
+	else if ((m_flag & Flag::file) && m_batch) run_batch_file();
+	else if (m_flag & Flag::file) run_file();
 	else if (m_flag & Flag::console) run_console();
 }
 
@@ -89,128 +125,356 @@ bool BFInterpreter::file() const throw() {
 	return m_flag & Flag::file;
 }
 
-void BFInterpreter::set_code(std::string const& code) throw() {
-	m_code = code;
+void BFInterpreter::set_optimization(Optimization const& optimization) throw() {
+	m_optimization = optimization;
 }
 
-bool BFInterpreter::is_usable_code(std::string const& code) const throw() {
-	int end_loop(0);
-	for (char c : code) {
-		if (c == ']') ++end_loop;
-		else if (c == '[') --end_loop;
-		if (end_loop > m_in_loop) return false;
-	}
-	return true;
+Optimization BFInterpreter::optimization() const throw() {
+	return m_optimization;
 }
 
-//---BRAINFUCK BASIC ACTION---
+void BFInterpreter::set_jit(bool const& jit) throw() {
+	m_jit = jit;
+}
 
-void BFInterpreter::start_loop() throw() {
-	++m_in_loop;
-	if (m_cell_vector[m_current_cell] != 0) {
-		m_loop_stack.push(m_current_action); //Save the place where the loop start			
-	}
-	else ++m_wait_for_end_loop;
+bool BFInterpreter::jit() const throw() {
+	return m_jit;
 }
 
-void BFInterpreter::end_loop() throw() {
-	if (m_cell_vector[m_current_cell] == 0) {
-		m_loop_stack.pop();
-		--m_in_loop;
-	}
-	else m_current_action = m_loop_stack.top();
+void BFInterpreter::set_parallel(bool const& parallel) throw() {
+	m_parallel = parallel;
 }
 
-void BFInterpreter::plus() throw() {
-	//Increment the pointed cell's value
-	++m_cell_vector[m_current_cell];
+bool BFInterpreter::parallel() const throw() {
+	return m_parallel;
 }
 
-void BFInterpreter::minus() throw() {
-	//Decrement the pointed cell's value
-	--m_cell_vector[m_current_cell];
+void BFInterpreter::set_interactive(bool const& interactive) throw() {
+	m_interactive = interactive;
 }
 
-void BFInterpreter::left() throw() {
-	//Move the pointer to the left
-	if (m_current_cell != 0) --m_current_cell;
+bool BFInterpreter::interactive() const throw() {
+	return m_interactive;
 }
 
-void BFInterpreter::right() throw() {
-	//Move the pointer to the right
-	if (++m_current_cell == m_cell_vector.size()) m_cell_vector.push_back(0);
+void BFInterpreter::set_tape(TapeKind const& kind, size_t const& size) throw() {
+	m_tape_kind = kind;
+	m_tape_size = size;
 }
 
-void BFInterpreter::input() throw() {
-	//Ask the user to enter an input
-	m_in->get(m_cell_vector[m_current_cell]);
+TapeKind BFInterpreter::tape_kind() const throw() {
+	return m_tape_kind;
 }
 
-void BFInterpreter::output() throw() {
-	//Prompt the pointed cell value
-	m_out->put(m_cell_vector[m_current_cell]);
-	if (m_running_console) *m_out << std::endl;
+void BFInterpreter::set_negative_cells(bool const& negative) throw() {
+	m_negative_cells = negative;
 }
 
-void BFInterpreter::execute_action(char const& action) throw() {
-	//Execute the action if the program don't have to end a loop
-	if (m_wait_for_end_loop == 0) {
-		switch (action) {
-		case '<':
-			left();
-			break;
-		case '>':
-			right();
-			break;
-		case '+':
-			plus();
-			break;
-		case '-':
-			minus();
-			break;
-		case '[':
-			start_loop();
-			break;
-		case ']':
-			end_loop();
-			break;
-		case '.':
-			output();
-			break;
-		case ',':
-			input();
-			break;
-		}
-	}
-	else {
-		switch (action) {
-		case '[':
-			//The code enter a new loop it must wait for another end
-			++m_wait_for_end_loop;
-			break;
-		case ']':
-			//The code ended a loop it don't have to end one of the loop encountered
-			--m_wait_for_end_loop;
-			break;
-		}
+bool BFInterpreter::negative_cells() const throw() {
+	return m_negative_cells;
+}
+
+void BFInterpreter::set_cell_bits(unsigned int const& bits) {
+	if (bits != 8 && bits != 16 && bits != 32)
+		throw std::invalid_argument("The cells can only be 8, 16 or 32 bits wide\n");
+	m_cell_bits = bits;
+}
+
+unsigned int BFInterpreter::cell_bits() const throw() {
+	return m_cell_bits;
+}
+
+void BFInterpreter::set_batch(BatchOptions const& options) {
+	m_batch = true;
+	m_batch_options = options;
+}
+
+bool BFInterpreter::batch() const throw() {
+	return m_batch;
+}
+
+void BFInterpreter::set_profile(std::string const& path) throw() {
+	m_profile_path = path;
+}
+
+std::string const& BFInterpreter::profile() const throw() {
+	return m_profile_path;
+}
+
+void BFInterpreter::set_limits(BFLimits const& limits) throw() {
+	m_limits = limits;
+}
+
+BFLimits const& BFInterpreter::limits() const throw() {
+	return m_limits;
+}
+
+void BFInterpreter::set_checkpoint(std::string const& path, double const& period) throw() {
+	m_checkpoint_path = path;
+	m_checkpoint_period = period;
+}
+
+std::string const& BFInterpreter::checkpoint() const throw() {
+	return m_checkpoint_path;
+}
+
+void BFInterpreter::set_resume(std::string const& path) throw() {
+	m_resume_path = path;
+}
+
+std::string const& BFInterpreter::resume() const throw() {
+	return m_resume_path;
+}
+
+void BFInterpreter::set_cache(std::string const& directory) throw() {
+	m_cache_path = directory;
+}
+
+std::string const& BFInterpreter::cache() const throw() {
+	return m_cache_path;
+}
+
+void BFInterpreter::set_metrics(std::string const& path) throw() {
+	m_metrics_path = path;
+}
+
+std::string const& BFInterpreter::metrics() const throw() {
+	return m_metrics_path;
+}
+
+void BFInterpreter::set_translation(std::string const& path) {
+	m_translation_path = path;
+}
+
+std::string const& BFInterpreter::translation() const throw() {
+	return m_translation_path;
+}
+
+void BFInterpreter::set_code(std::string const& code) throw() {
+	clear_code();
+	read_string(code);
+}
+
+void BFInterpreter::set_source(std::string const& path) {
+	clear_code();
+	auto const start = std::chrono::steady_clock::now();
+	m_source.reset(new BFSource(path));
+	m_load_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool BFInterpreter::is_usable_code(std::string const& code) const throw() {
+	int end_loop(0);
+	for (char c : code) {
+		if (c == ']') ++end_loop;
+		else if (c == '[') --end_loop;
+		if (end_loop > static_cast<int>(m_console_program.open_loops().size())) return false;
 	}
+	return true;
 }
 
 //---HELPING METHODS---
 
-void BFInterpreter::run_code_part(int start) throw() {
-	for (m_current_action = start; m_current_action != m_code.size(); ++m_current_action)
-		execute_action(m_code[m_current_action]);
-};
+void BFInterpreter::run_console_code() {
+	BFLastInstruction last;
+	last.instruction = m_console_program.size();
+	size_t const next = m_tape->run(m_console_program, m_current_action, *m_input, *m_output, last);
+	//A '[' whose ']' has not been entered yet skipped the end of the code,
+	//the rest of the code is run from it once the loop is closed
+	std::vector<size_t> const& open = m_console_program.open_loops();
+	if (std::find(open.begin(), open.end(), last.instruction) != open.end()
+		&& m_tape->value(m_tape->position()) == 0)
+		m_current_action = last.instruction;
+	else m_current_action = next;
+}
 
-void BFInterpreter::run_file(int start) throw() {
+BFProgram BFInterpreter::compile() const {
+	char const* first = m_source ? m_source->begin() : m_code.data();
+	char const* last = m_source ? m_source->end() : m_code.data() + m_code.size();
+	if (!m_cache_path.empty()) return compile_cached(m_cache_path, first, last, m_optimization, m_cell_bits, m_limits);
+	return BFProgram(first, last, m_optimization);
+}
+
+void BFInterpreter::run_file() {
 	initialize();
-	run_code_part(start);
+	auto const start = std::chrono::steady_clock::now();
+	BFProgram program = compile();
+	//The prefix kept by the cache is skipped, except by the runs that count
+	//or save the instructions they run
+	BFPrefix const& prefix = program.prefix();
+	if (prefix.instruction != 0 && prefix.cell_bits == m_cell_bits && m_profile_path.empty() && m_limits.empty()
+		&& m_checkpoint_path.empty() && m_resume_path.empty() && m_metrics_path.empty() && restore_prefix(prefix, *m_tape)) {
+		m_output->write(prefix.output.data(), prefix.output.size());
+		program = rest_of_prefix(program);
+	}
+	double const compile_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::unique_ptr<BFProfile> profile;
+	if (!m_profile_path.empty()) profile.reset(new BFProfile(program));
+	m_budget.reset(m_limits.empty() ? nullptr : new BFBudget(m_limits));
+	m_tape->set_budget(m_budget.get());
+	try {
+		//The tape runs the program with the JIT when it is asked and available
+		if (!m_checkpoint_path.empty() || !m_resume_path.empty()) run_checkpointed(program);
+		else if (!m_metrics_path.empty()) run_metered(program, compile_seconds);
+		else if (profile) m_tape->run(program, *m_input, *m_output, *profile);
+		else if (m_parallel) m_tape->run_parallel(program, *m_input, *m_output);
+		else if (m_jit) m_tape->run_native(program, *m_input, *m_output);
+		else m_tape->run(program, *m_input, *m_output);
+	}
+	catch (...) {
+		//What the program wrote comes before the error
+		m_output->flush();
+		//The profile shows where the program was going when it failed
+		if (profile) write_profile(program, *profile);
+		throw;
+	}
+	m_output->flush();
+	if (profile) write_profile(program, *profile);
+	if (m_output->fail()) throw std::runtime_error("Unable to write the output of the program\n");
+}
+
+void BFInterpreter::run_batch_file() const {
+	BatchOptions options(m_batch_options);
+	options.tape_kind = m_tape_kind;
+	options.tape_size = m_tape_size;
+	options.negative_cells = m_negative_cells;
+	options.cell_bits = m_cell_bits;
+	options.limits = m_limits;
+	BFProgram program = compile();
+	//The prefix is run once for the whole batch, each input starts from its
+	//state, unless the inputs are given limits which count its instructions
+	BFPrefix prefix;
+	if ((m_optimization & Optimization::prefix) && m_limits.empty()) {
+		prefix = program.prefix();
+		if (prefix.instruction == 0 && m_cache_path.empty()) prefix = evaluate_prefix(program, m_cell_bits);
+		std::unique_ptr<BFTape> tape(create_tape(m_tape_kind, m_tape_size, m_cell_bits, m_negative_cells));
+		if (prefix.instruction != 0 && restore_prefix(prefix, *tape)) {
+			program.set_prefix(prefix);
+			program = rest_of_prefix(program);
+		}
+		else prefix = BFPrefix();
+	}
+	//The native code is compiled once and shared by every thread
+	std::unique_ptr<BFJit> jit;
+	if (m_jit && m_cell_bits == 8 && m_tape_kind != TapeKind::paged && BFJit::supported())
+		jit.reset(new BFJit(program, m_tape_kind == TapeKind::vector, !m_limits.empty()));
+	run_batch(program, jit.get(), prefix.instruction != 0 ? &prefix : nullptr, options);
+}
+
+void BFInterpreter::run_checkpointed(BFProgram const& program) {
+	uint64_t const hash = hash_program(program);
+	size_t next(0);
+	uint64_t output_before(0);
+	if (!m_resume_path.empty()) {
+		BFCheckpoint checkpoint = load_checkpoint(m_resume_path);
+		if (checkpoint.program != hash || checkpoint.cell_bits != m_cell_bits || checkpoint.instruction > program.size())
+			throw std::runtime_error("The checkpoint '" + m_resume_path + "' was not saved by this program with these cells\n");
+		for (size_t cell(0); cell != checkpoint.cells.size(); ++cell)
+			if (checkpoint.cells[cell] != 0) m_tape->set_value(cell, checkpoint.cells[cell]);
+		m_tape->seek(checkpoint.position);
+		next = checkpoint.instruction;
+		output_before = checkpoint.output;
+		char c;
+		for (uint64_t read(0); read != checkpoint.input && m_input->get(c); ++read) {}
+	}
+
+	if (!m_checkpoint_path.empty()) {
+		BFCheckpointTrigger::install(m_checkpoint_period);
+		m_input->set_interruption(&BFCheckpointTrigger::requested);
+	}
+	BFCheckpointTrigger trigger;
+	try {
+		//The run stops at a back-edge each time a checkpoint is asked
+		while ((next = m_tape->run(program, next, *m_input, *m_output, trigger)) != program.size()) {
+			m_output->flush();
+			BFCheckpoint checkpoint;
+			checkpoint.cell_bits = m_cell_bits;
+			checkpoint.program = hash;
+			checkpoint.instruction = next;
+			checkpoint.position = m_tape->position();
+			checkpoint.input = m_input->count();
+			checkpoint.output = output_before + m_output->count();
+			size_t const extent = m_tape->extent();
+			checkpoint.cells.resize(extent);
+			for (size_t cell(0); cell != extent; ++cell)
+				checkpoint.cells[cell] = static_cast<uint32_t>(m_tape->value(cell));
+			save_checkpoint(m_checkpoint_path, checkpoint);
+			BFCheckpointTrigger::clear();
+			if (BFCheckpointTrigger::terminated()) {
+				//Not an error, the output must only hold what the program wrote
+				std::cerr << "Stopped by SIGTERM, the run is saved in '" << m_checkpoint_path << "'\n";
+				break;
+			}
+		}
+	}
+	catch (...) {
+		BFCheckpointTrigger::uninstall();
+		m_input->set_interruption(nullptr);
+		throw;
+	}
+	BFCheckpointTrigger::uninstall();
+	m_input->set_interruption(nullptr);
+}
+
+void BFInterpreter::run_metered(BFProgram const& program, double const& compile_seconds) {
+	BFMetrics metrics(program, m_budget.get());
+	auto const start = std::chrono::steady_clock::now();
+	auto write = [&](bool const& running) {
+		BFMetricsReport report;
+		report.running = running;
+		report.instructions = metrics.instructions();
+		report.iterations = metrics.iterations();
+		report.input = m_input->count();
+		report.output = m_output->count();
+		report.cells = m_tape->reached();
+		report.load_seconds = m_load_seconds;
+		report.compile_seconds = compile_seconds;
+		report.execute_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::ofstream file(m_metrics_path);
+		write_metrics(file, report);
+		if (file.fail()) throw std::runtime_error("Unable to write the metrics\n");
+	};
+
+	BFMetrics::install();
+	m_input->set_interruption(&BFMetrics::requested);
+	try {
+		//The run stops at a back-edge or at a read waiting for input each time
+		//the metrics are asked
+		size_t next(0);
+		while ((next = m_tape->run(program, next, *m_input, *m_output, metrics)) != program.size()) {
+			if (m_budget && (m_budget->timeout() || m_budget->exhausted()))
+				throw limit_exceeded(m_budget->timeout(), m_budget->spent(), m_budget->seconds(), m_tape->position());
+			write(true);
+			BFMetrics::clear();
+		}
+		metrics.reached(next);
+	}
+	catch (...) {
+		BFMetrics::uninstall();
+		m_input->set_interruption(nullptr);
+		//The metrics show how far the program went before failing
+		write(false);
+		throw;
+	}
+	BFMetrics::uninstall();
+	m_input->set_interruption(nullptr);
+	write(false);
 }
 
-void BFInterpreter::run_console() throw() {
+void BFInterpreter::write_profile(BFProgram const& program, BFProfile const& profile) const {
+	char const* first = m_source ? m_source->begin() : m_code.data();
+	char const* last = m_source ? m_source->end() : m_code.data() + m_code.size();
+	std::ofstream report(m_profile_path);
+	profile.write_report(report, program, first, last);
+	std::ofstream folded(m_profile_path + ".folded");
+	profile.write_folded(folded, program, first, last);
+	if (report.fail() || folded.fail()) throw std::runtime_error("Unable to write the profile\n");
+}
+
+void BFInterpreter::run_console() {
 	m_running_console = true;
 	initialize();
+	m_console_program = BFProgram(std::string(), m_optimization);
+	m_console_program.append(m_code.data(), m_code.data() + m_code.size());
 	m_current_action = 0;
 
 	std::string user_input;
@@ -235,11 +499,32 @@ void BFInterpreter::run_console() throw() {
 	}
 }
 
-void BFInterpreter::initialize() throw() {
+void BFInterpreter::translate() const {
+	translate_to_file(m_translation_path, compile(), m_cell_bits);
+}
+
+void BFInterpreter::initialize() {
+	//The standard streams are bypassed for their file descriptors, except by the
+	//console which reads its commands from the same stream
+	bool interactive = m_interactive || m_running_console;
+	//The output being written may use the stream of the console
+	m_output.reset();
+	if (m_running_console) {
+		m_console_buffer.reset(new LineBuffer(*m_out));
+		m_console_out.reset(new std::ostream(m_console_buffer.get()));
+		m_output.reset(new BFOutput(*m_console_out, interactive));
+	}
+	else if (m_out == &std::cout) {
+		std::cout.flush();
+		m_output.reset(new BFOutput(STDOUT_FILENO, interactive));
+	}
+	else m_output.reset(new BFOutput(*m_out, interactive));
+	if (m_in == &std::cin && !m_running_console) m_input.reset(new BFInput(STDIN_FILENO, interactive));
+	else m_input.reset(new BFInput(*m_in, interactive));
+	m_input->tie(m_output.get());
+
 	//Set all value to their default state
-	m_current_cell = 0;
-	m_cell_vector = std::vector<char>(1, 0);
-	m_loop_stack = std::stack<size_t>();
+	m_tape.reset(create_tape(m_tape_kind, m_tape_size, m_cell_bits, m_negative_cells));
 }
 
 void BFInterpreter::read_string(std::string const& code) throw() {
@@ -251,9 +536,15 @@ void BFInterpreter::add_char(char const& new_char) throw() {
 	if (is_valid_brainfuck_char(new_char)) m_code.push_back(new_char);
 }
 
+void BFInterpreter::clear_code() throw() {
+	m_source.reset();
+	m_code.clear();
+	m_console_program = BFProgram(std::string(), m_optimization);
+}
+
 //---COMMAND METHOD---
 
-void BFInterpreter::process_console_input(std::vector<std::string>& args) throw() {
+void BFInterpreter::process_console_input(std::vector<std::string>& args) {
 	std::string command = *args.begin();
 	args.erase(args.begin());
 	try {
@@ -298,9 +589,9 @@ void BFInterpreter::command_help() const throw() {
 	*m_out << CONSOLE_HELP;
 }
 
-void BFInterpreter::command_end() throw() {
+void BFInterpreter::command_end() {
 	*m_out << "Ending script, reset all value.\n";
-	m_code = std::string();
+	clear_code();
 	initialize();
 	m_current_action = 0;
 }
@@ -314,42 +605,56 @@ void BFInterpreter::command_cell(std::vector<std::string> const& arg) const {
 	//If no argument has been passed or '-a' has been passed all the integer value of the cells ar printed
 	if (arg.empty() 
 		|| (arg[0] == "-a" && arg.size() != 2)) {
-		//'-a' or no args has been passed so we show a range of cells
-		unsigned int range[2] {0, m_cell_vector.size() - 1};
+		//'-a' or no args has been passed so we show the cells that exist, a
+		//paged tape only shows its pages
+		std::vector<std::pair<long, long>> ranges = m_tape->ranges();
 
 		if (arg.size() == 3) {
 			//If some args has been passed we show a specified range
+			long range[2];
 			for (int i(0); i != 2; ++i)
 				if (!(std::stringstream(arg[i + 1]) >> range[i])) 
 					throw std::invalid_argument("'-a' takes integers as argument\n");
 			
 			if (range[0] > range[1]) throw std::invalid_argument("first can't be greater than end\n");
+			for (int i(0); i != 2; ++i)
+				if (!m_tape->exists(range[i])) throw cell_out_of_range(range[i]);
+			ranges.assign(1, { range[0], range[1] + 1 });
 		}
 
-		print_array(*m_out, 
-			m_cell_vector.begin() + range[0], 
-			m_cell_vector.begin() + range[1] + 1, 
-			[](char const& c) throw() { return static_cast<int>(c); });
-		*m_out << std::endl;
-
-		point_cell(*m_out, 
-			m_cell_vector, 
-			m_current_cell - range[0],
-			[](char const& c) throw() { return static_cast<int>(c); });
+		bool const several = ranges.size() != 1 || ranges[0].first != 0;
+		for (std::pair<long, long> const& range : ranges) {
+			if (several) *m_out << "Cells " << range.first << " to " << range.second - 1 << ":\n";
+			std::vector<unsigned long> values;
+			for (long cell(range.first); cell != range.second; ++cell)
+				values.push_back(m_tape->value(cell));
+
+			print_array(*m_out, 
+				values.begin(), 
+				values.end(), 
+				[](unsigned long const& c) throw() { return c; });
+			*m_out << std::endl;
+
+			if (m_tape->position() >= range.first && m_tape->position() < range.second)
+				point_cell(*m_out, 
+					values, 
+					m_tape->position() - range.first,
+					[](unsigned long const& c) throw() { return c; });
+		}
 	}
 
 	else if (arg[0] == "-c" && arg.size() < 3) {
 		//'-c' has been passed so we show the value of one cell
-		unsigned int cell = m_current_cell;
+		long cell = m_tape->position();
 		
 		//if 1 argument has been passed and it is not an integer we throw an exception
 		if (arg.size() == 2)
 			if (!(std::stringstream(arg[1]) >> cell)) 
 				throw std::invalid_argument("'-c' take integers as argument\n");
 		
-		if (cell >= m_cell_vector.size()) throw cell_out_of_range(cell);
+		if (!m_tape->exists(cell)) throw cell_out_of_range(cell);
 		
-		*m_out << "Cell: " << cell << " with value: " << static_cast<int>(m_cell_vector[cell]) << std::endl;
+		*m_out << "Cell: " << cell << " with value: " << m_tape->value(cell) << std::endl;
 	}
 	else throw std::invalid_argument("this command syntax is:\ncell -a [<first> <end>] | -c [<pos>]\n");
 }
@@ -369,11 +674,20 @@ void BFInterpreter::command_prompt(std::vector<std::string> const& args) {
 	m_prompt = std::accumulate(args.begin(), args.end(), std::string());
 }
 
-void BFInterpreter::read_console_brainfuck(std::string const& input) throw() {
+void BFInterpreter::read_console_brainfuck(std::string const& input) {
 	//Verify is the bracket are correct and run code entered in console
 	if (is_usable_code(input)) {
 		read_string(input);
-		run_code_part(m_current_action);
+		try {
+			//Only the new code is compiled, the program goes on where it stopped
+			m_console_program.append(input.data(), input.data() + input.size());
+			run_console_code();
+		}
+		catch (tape_out_of_bounds const& e) {
+			//The script can't go on once the pointer left the tape
+			*m_out << e.what();
+			command_end();
+		}
 	}
 	else *m_out << "'[' and ']' are not balance, try use 'code' command to see previous code\n";
 }
@@ -0,0 +1,180 @@
+#include "io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <unistd.h>
+
+//---OUTPUT---
+
+const size_t BFOutput::BUFFER_SIZE = 1 << 16;
+
+BFOutput::BFOutput(int const& fd, bool const& interactive) :
+	m_stream(nullptr),
+	m_fd(fd),
+	m_buffer(BUFFER_SIZE),
+	m_first(m_buffer.data()),
+	m_next(m_first),
+	m_limit(m_first + (interactive ? 1 : BUFFER_SIZE)),
+	m_written(0),
+	m_span(false),
+	m_interactive(interactive),
+	m_failed(false) {};
+
+BFOutput::BFOutput(std::ostream& out, bool const& interactive) :
+	BFOutput(-1, interactive) {
+	m_stream = &out;
+}
+
+BFOutput::BFOutput(char* span, size_t const& capacity) :
+	m_stream(nullptr),
+	m_fd(-1),
+	m_first(span),
+	m_next(span),
+	m_limit(span + capacity),
+	m_written(0),
+	m_span(true),
+	m_interactive(false),
+	m_failed(false) {
+	//An empty span is already full
+	if (capacity == 0) flush();
+}
+
+BFOutput::~BFOutput() {
+	flush();
+}
+
+void BFOutput::flush() throw() {
+	char const* first = m_first;
+	size_t const size = m_next - first;
+	m_next = m_first;
+	if (m_span) {
+		if (m_first == m_discard) {
+			//Bytes that didn't fit in the span
+			m_written += size;
+			if (size != 0) m_failed = true;
+		}
+		else if (m_next + size == m_limit) {
+			//The span is full, the next bytes are counted and dropped
+			m_written += size;
+			m_first = m_next = m_discard;
+			m_limit = m_discard + sizeof(m_discard);
+		}
+		else m_next += size;
+		return;
+	}
+	m_written += size;
+	if (size == 0 || m_failed) return;
+	if (m_stream) {
+		m_stream->write(first, size);
+		//Only an interactive output needs to be seen right away
+		if (m_interactive) m_stream->flush();
+		m_failed = m_stream->fail();
+		return;
+	}
+	for (size_t written(0); written != size;) {
+		ssize_t n = ::write(m_fd, first + written, size - written);
+		if (n < 0 && errno == EINTR) continue;
+		if (n <= 0) {
+			m_failed = true;
+			return;
+		}
+		written += n;
+	}
+}
+
+bool BFOutput::fail() const throw() {
+	return m_failed;
+}
+
+size_t BFOutput::count() const throw() {
+	return m_written + (m_next - m_first);
+}
+
+//---INPUT---
+
+const size_t BFInput::BUFFER_SIZE = 1 << 16;
+
+BFInput::BFInput(int const& fd, bool const& interactive) :
+	m_stream(nullptr),
+	m_fd(fd),
+	m_interactive(interactive),
+	m_buffer(BUFFER_SIZE),
+	m_first(m_buffer.data()),
+	m_next(m_first),
+	m_end(m_first),
+	m_before(0),
+	m_tied(nullptr),
+	m_interruption(nullptr),
+	m_interrupted(false) {};
+
+BFInput::BFInput(std::istream& in, bool const& interactive) :
+	BFInput(-1, interactive) {
+	m_stream = &in;
+}
+
+BFInput::BFInput(char const* span, size_t const& size) :
+	m_stream(nullptr),
+	m_fd(-1),
+	m_interactive(false),
+	m_first(span),
+	m_next(span),
+	m_end(span + size),
+	m_before(0),
+	m_tied(nullptr),
+	m_interruption(nullptr),
+	m_interrupted(false) {};
+
+void BFInput::tie(BFOutput* out) throw() {
+	m_tied = out;
+}
+
+void BFInput::set_interruption(bool (*interruption)()) throw() {
+	m_interruption = interruption;
+}
+
+bool BFInput::interrupted() const throw() {
+	return m_interrupted;
+}
+
+size_t BFInput::count() const throw() {
+	return m_before + (m_next - m_first);
+}
+
+bool BFInput::refill() {
+	m_interrupted = false;
+	//A span has nothing more than what it was given
+	if (!m_stream && m_fd < 0) return false;
+	//The output may be a prompt the user needs to see before typing
+	if (m_tied) m_tied->flush();
+	char* first = m_buffer.data();
+	m_before += m_end - m_first;
+	m_first = m_next = m_end = first;
+	if (m_stream) {
+		std::streambuf* buffer = m_stream->rdbuf();
+		std::streamsize available = m_interactive ? 0 : buffer->in_avail();
+		//Take what the stream already has, or wait for a single byte
+		if (available > 0) {
+			m_end = first + buffer->sgetn(first, std::min<std::streamsize>(available, BUFFER_SIZE));
+		}
+		else {
+			char c;
+			if (!m_stream->get(c)) return false;
+			first[0] = c;
+			m_end = first + 1;
+		}
+		return m_end != first;
+	}
+	ssize_t n;
+	for (;;) {
+		//A signal received before the read would not interrupt it
+		if (m_interruption && m_interruption()) {
+			m_interrupted = true;
+			return false;
+		}
+		n = read(m_fd, first, BUFFER_SIZE);
+		if (n >= 0 || errno != EINTR) break;
+	}
+	if (n <= 0) return false;
+	m_end = first + n;
+	return true;
+}
@@ -0,0 +1,489 @@
+#include "jit.h"
+
+#include "bfexception.h"
+#include "scan.h"
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <initializer_list>
+#include <stack>
+#include <stdexcept>
+
+#if defined(__x86_64__) && (defined(__unix__) || defined(__APPLE__))
+#define BF_JIT_X86_64
+#include <sys/mman.h>
+#endif
+
+#ifdef BF_JIT_X86_64
+
+//---CALLBACKS OF THE GENERATED CODE---
+
+//Make the call, an exception it throws is kept in the context and rethrown
+//once the run is back out of the generated code, which has no unwind information
+template<class Call>
+static void jit_call(BFJit::Context* context, Call const& call) {
+	try {
+		call();
+		return;
+	}
+	catch (...) {
+		context->failure = std::current_exception();
+	}
+	std::longjmp(context->error, 3);
+}
+
+static void jit_output(BFJit::Context* context, unsigned char* cell) {
+	jit_call(context, [&]() { context->out->put(static_cast<char>(*cell)); });
+}
+
+static void jit_input(BFJit::Context* context, unsigned char* cell) {
+	char c;
+	bool read(false);
+	jit_call(context, [&]() { read = context->in->get(c); });
+	if (read) *cell = static_cast<unsigned char>(c);
+}
+
+static unsigned char* jit_resize(BFJit::Context* context, long const& index) {
+	jit_call(context, [&]() { context->cells->resize(index + 1, 0); });
+	context->begin = context->cells->data();
+	context->end = context->begin + context->cells->size();
+	return context->begin;
+}
+
+static void jit_fail(BFJit::Context* context, long const& index) {
+	context->bad_cell = index;
+	std::longjmp(context->error, 1);
+}
+
+//Called when a move put the pointer out of the tape, return the new pointer
+static unsigned char* jit_move(BFJit::Context* context, unsigned char* cell) {
+	long index = cell - context->begin;
+	if (index < 0) jit_fail(context, index);
+	return jit_resize(context, index) + index;
+}
+
+//Make the cell at offset of the pointer exist, return the pointer
+static unsigned char* jit_reserve(BFJit::Context* context, unsigned char* cell, long offset) {
+	long index = cell - context->begin;
+	if (index + offset < 0) jit_fail(context, index + offset);
+	if (index + offset >= context->end - context->begin) jit_resize(context, index + offset);
+	return context->begin + index;
+}
+
+//Run a scan loop from the pointed cell, the cells past the end are zero
+static unsigned char* jit_scan(BFJit::Context* context, unsigned char* cell, long stride) {
+	long index = find_zero(cell, static_cast<int>(stride), context->begin, context->end) - context->begin;
+	if (index < 0) jit_fail(context, index);
+	if (index >= context->end - context->begin) return jit_resize(context, index) + index;
+	return context->begin + index;
+}
+
+//Called when a back-edge spent the allowance of the budget
+static void jit_budget(BFJit::Context* context, unsigned char* cell, long instructions) {
+	//The generated code took the instructions from the allowance before the call
+	context->left += instructions;
+	if (!context->budget) {
+		context->left = ULLONG_MAX;
+		return;
+	}
+	context->budget->set_left(context->left);
+	bool running(false);
+	jit_call(context, [&]() { running = context->budget->back_edge(instructions); });
+	context->left = context->budget->left();
+	if (running) return;
+	context->stopped = cell;
+	std::longjmp(context->error, 2);
+}
+
+//---CODE GENERATION---
+
+//Growing buffer of x86-64 machine code
+//The pointer is kept in rbx, the context in r12, the tape bounds in r13 and r14
+struct Assembler {
+	std::vector<unsigned char> code;
+	bool checked;
+
+	void emit(std::initializer_list<unsigned char> bytes) {
+		code.insert(code.end(), bytes.begin(), bytes.end());
+	}
+
+	void emit32(int32_t value) {
+		unsigned char bytes[4];
+		std::memcpy(bytes, &value, 4);
+		code.insert(code.end(), bytes, bytes + 4);
+	}
+
+	void emit64(uint64_t value) {
+		unsigned char bytes[8];
+		std::memcpy(bytes, &value, 8);
+		code.insert(code.end(), bytes, bytes + 8);
+	}
+
+	//Emit a short conditional jump and return where its target must be written
+	size_t jump8(unsigned char opcode) {
+		emit({ opcode, 0 });
+		return code.size() - 1;
+	}
+
+	void land8(size_t const& patch) {
+		code[patch] = static_cast<unsigned char>(code.size() - patch - 1);
+	}
+
+	//Emit a near jump to an unknown target, return where the target must be written
+	size_t jump32(std::initializer_list<unsigned char> opcode) {
+		emit(opcode);
+		emit32(0);
+		return code.size() - 4;
+	}
+
+	void land32(size_t const& patch, size_t const& target) {
+		int32_t relative = static_cast<int32_t>(target - (patch + 4));
+		std::memcpy(&code[patch], &relative, 4);
+	}
+
+	//The callback is given the cell at offset of the pointer
+	void call(void const* function, int const& offset = 0) {
+		emit({ 0x4C, 0x89, 0xE7 });	//mov rdi, r12
+		if (offset == 0) emit({ 0x48, 0x89, 0xDE });	//mov rsi, rbx
+		else {
+			emit({ 0x48, 0x8D, 0xB3 });	//lea rsi, [rbx + offset]
+			emit32(offset);
+		}
+		emit({ 0x48, 0xB8 });		//mov rax, function
+		emit64(reinterpret_cast<uint64_t>(function));
+		emit({ 0xFF, 0xD0 });		//call rax
+	}
+
+	//Take the pointer returned by a callback that may have moved the tape
+	void reload() {
+		emit({ 0x48, 0x89, 0xC3 });	//mov rbx, rax
+		emit({ 0x4D, 0x8B, 0x6C, 0x24, static_cast<unsigned char>(offsetof(BFJit::Context, begin)) });	//mov r13, [r12 + begin]
+		emit({ 0x4D, 0x8B, 0x74, 0x24, static_cast<unsigned char>(offsetof(BFJit::Context, end)) });	//mov r14, [r12 + end]
+	}
+
+	void move(int const& arg) {
+		emit({ 0x48, 0x81, 0xC3 });	//add rbx, arg
+		emit32(arg);
+		if (!checked) return;
+		size_t inside;
+		if (arg > 0) {
+			emit({ 0x4C, 0x39, 0xF3 });	//cmp rbx, r14
+			inside = jump8(0x72);		//jb inside
+		}
+		else {
+			emit({ 0x4C, 0x39, 0xEB });	//cmp rbx, r13
+			inside = jump8(0x73);		//jae inside
+		}
+		call(reinterpret_cast<void const*>(&jit_move));
+		reload();
+		land8(inside);
+	}
+
+	//Check the cell at offset of the pointer before using it, the pointed cell always exists
+	void use(int const& offset) {
+		if (checked && offset != 0) reserve(offset);
+	}
+
+	//Make the cell at offset of the pointer exist
+	void reserve(int const& offset) {
+		emit({ 0x48, 0x8D, 0x8B });	//lea rcx, [rbx + offset]
+		emit32(offset);
+		emit({ 0x4C, 0x39, 0xF1 });	//cmp rcx, r14
+		size_t outside = jump8(0x73);	//jae outside
+		emit({ 0x4C, 0x39, 0xE9 });	//cmp rcx, r13
+		size_t inside = jump8(0x73);	//jae inside
+		land8(outside);
+		emit({ 0x48, 0xC7, 0xC2 });	//mov rdx, offset
+		emit32(offset);
+		call(reinterpret_cast<void const*>(&jit_reserve));
+		reload();
+		land8(inside);
+	}
+};
+
+//Generate the instructions from begin to end, which hold whole loops
+static void generate_range(Assembler& a, std::vector<Instruction> const& instructions,
+						   size_t const& begin, size_t const& end, bool const& limited) {
+	//Position of the 'je' of the '[' waiting for their ']'
+	std::stack<size_t> open_loop;
+	for (size_t i(begin); i != end; ++i) {
+		Instruction const& action = instructions[i];
+		switch (action.op) {
+		case OpCode::ADD:
+			a.use(action.offset);
+			if (action.offset == 0) a.emit({ 0x80, 0x03, static_cast<unsigned char>(action.arg) });	//add byte [rbx], arg
+			else {
+				a.emit({ 0x80, 0x83 });	//add byte [rbx + offset], arg
+				a.emit32(action.offset);
+				a.emit({ static_cast<unsigned char>(action.arg) });
+			}
+			break;
+		case OpCode::MOVE:
+			a.move(action.arg);
+			break;
+		case OpCode::OPEN:
+			a.emit({ 0x80, 0x3B, 0x00 });	//cmp byte [rbx], 0
+			open_loop.push(a.jump32({ 0x0F, 0x84 }));	//je after ']'
+			break;
+		case OpCode::CLOSE: {
+			a.emit({ 0x80, 0x3B, 0x00 });	//cmp byte [rbx], 0
+			if (!limited) {
+				size_t back = a.jump32({ 0x0F, 0x85 });	//jne after '['
+				a.land32(back, open_loop.top() + 4);
+			}
+			else {
+				size_t end = a.jump32({ 0x0F, 0x84 });	//je end
+				//Spend the length of the loop, the budget is called once the allowance is empty
+				int32_t length = static_cast<int32_t>(&action - instructions.data() - action.arg);
+				a.emit({ 0x49, 0x81, 0x6C, 0x24, static_cast<unsigned char>(offsetof(BFJit::Context, left)) });	//sub qword [r12 + left], length
+				a.emit32(length);
+				size_t spent = a.jump8(0x77);	//ja spent
+				a.emit({ 0x48, 0xC7, 0xC2 });	//mov rdx, length
+				a.emit32(length);
+				a.call(reinterpret_cast<void const*>(&jit_budget));
+				a.land8(spent);
+				a.land32(a.jump32({ 0xE9 }), open_loop.top() + 4);	//jmp after '['
+				a.land32(end, a.code.size());
+			}
+			a.land32(open_loop.top(), a.code.size());
+			open_loop.pop();
+			break;
+		}
+		case OpCode::INPUT:
+			a.use(action.offset);
+			a.call(reinterpret_cast<void const*>(&jit_input), action.offset);
+			break;
+		case OpCode::OUTPUT:
+			a.use(action.offset);
+			a.call(reinterpret_cast<void const*>(&jit_output), action.offset);
+			break;
+		case OpCode::CLEAR:
+			a.use(action.offset);
+			if (action.offset == 0) a.emit({ 0xC6, 0x03, 0x00 });	//mov byte [rbx], 0
+			else {
+				a.emit({ 0xC6, 0x83 });	//mov byte [rbx + offset], 0
+				a.emit32(action.offset);
+				a.emit({ 0x00 });
+			}
+			break;
+		case OpCode::SCAN: {
+			if (a.checked) {
+				a.emit({ 0x80, 0x3B, 0x00 });	//cmp byte [rbx], 0
+				size_t end = a.jump32({ 0x0F, 0x84 });	//je end
+				a.emit({ 0x48, 0xC7, 0xC2 });	//mov rdx, stride
+				a.emit32(action.arg);
+				a.call(reinterpret_cast<void const*>(&jit_scan));
+				a.reload();
+				a.land32(end, a.code.size());
+				break;
+			}
+			//The bounds of a guarded tape are not known, a scan leaving it must fault in the guard region
+			size_t loop = a.code.size();
+			a.emit({ 0x80, 0x3B, 0x00 });	//cmp byte [rbx], 0
+			size_t end = a.jump32({ 0x0F, 0x84 });	//je end
+			a.move(action.arg);
+			a.land32(a.jump32({ 0xE9 }), loop);	//jmp loop
+			a.land32(end, a.code.size());
+			break;
+		}
+		case OpCode::MUL: {
+			a.emit({ 0x0F, 0xB6, 0x03 });	//movzx eax, byte [rbx]
+			a.emit({ 0x84, 0xC0 });			//test al, al
+			size_t end = a.jump32({ 0x0F, 0x84 });	//je end
+			if (!a.checked) {
+				a.emit({ 0x69, 0xC0 });		//imul eax, eax, arg
+				a.emit32(action.arg);
+				a.emit({ 0x00, 0x83 });		//add byte [rbx + offset], al
+				a.emit32(action.offset);
+				a.land32(end, a.code.size());
+				break;
+			}
+			a.emit({ 0x48, 0x8D, 0x8B });	//lea rcx, [rbx + offset]
+			a.emit32(action.offset);
+			a.emit({ 0x4C, 0x39, 0xF1 });	//cmp rcx, r14
+			size_t outside = a.jump8(0x73);	//jae outside
+			a.emit({ 0x4C, 0x39, 0xE9 });	//cmp rcx, r13
+			size_t inside = a.jump8(0x73);	//jae inside
+			a.land8(outside);
+			a.emit({ 0x48, 0xC7, 0xC2 });	//mov rdx, offset
+			a.emit32(action.offset);
+			a.call(reinterpret_cast<void const*>(&jit_reserve));
+			a.reload();
+			a.emit({ 0x0F, 0xB6, 0x03 });	//movzx eax, byte [rbx]
+			a.land8(inside);
+			a.emit({ 0x69, 0xC0 });			//imul eax, eax, arg
+			a.emit32(action.arg);
+			a.emit({ 0x00, 0x83 });			//add byte [rbx + offset], al
+			a.emit32(action.offset);
+			a.land32(end, a.code.size());
+			break;
+		}
+		case OpCode::RESERVE: {
+			if (!a.checked) break;
+			size_t const open = i + 1;
+			size_t const close = instructions[open].arg;
+			//The loop is also generated with checks, for when its lowest cell
+			//doesn't exist, so that it stops on the move leaving the tape
+			a.emit({ 0x48, 0x8D, 0x8B });	//lea rcx, [rbx + arg]
+			a.emit32(action.arg);
+			a.emit({ 0x4C, 0x39, 0xE9 });	//cmp rcx, r13
+			size_t checked = a.jump32({ 0x0F, 0x82 });	//jb checked
+			a.reserve(action.offset);
+			a.checked = false;
+			generate_range(a, instructions, open, close + 1, limited);
+			a.checked = true;
+			size_t done = a.jump32({ 0xE9 });	//jmp done
+			a.land32(checked, a.code.size());
+			generate_range(a, instructions, open, close + 1, limited);
+			a.land32(done, a.code.size());
+			i = close;
+			break;
+		}
+		}
+	}
+}
+
+static std::vector<unsigned char> generate(BFProgram const& program, bool const& checked, bool const& limited) {
+	Assembler a;
+	a.checked = checked;
+	//Prologue, the five pushes keep the stack aligned for the callbacks
+	a.emit({ 0x53, 0x41, 0x54, 0x41, 0x55, 0x41, 0x56, 0x41, 0x57 });	//push rbx, r12, r13, r14, r15
+	a.emit({ 0x49, 0x89, 0xFC });	//mov r12, rdi
+	a.emit({ 0x48, 0x89, 0xF3 });	//mov rbx, rsi
+	a.emit({ 0x48, 0x89, 0xD8 });	//mov rax, rbx
+	a.reload();
+
+	generate_range(a, program.instructions(), 0, program.size(), limited);
+
+	//Epilogue, the last pointer is returned
+	a.emit({ 0x48, 0x89, 0xD8 });	//mov rax, rbx
+	a.emit({ 0x41, 0x5F, 0x41, 0x5E, 0x41, 0x5D, 0x41, 0x5C, 0x5B });	//pop r15, r14, r13, r12, rbx
+	a.emit({ 0xC3 });	//ret
+	return a.code;
+}
+
+bool BFJit::supported() throw() {
+	return true;
+}
+
+BFJit::BFJit(BFProgram const& program, bool const& checked, bool const& limited) :
+	m_code(nullptr),
+	m_size(0),
+	m_checked(checked),
+	m_limited(limited),
+	m_reach(program.reach()) {
+	std::vector<unsigned char> code = generate(program, checked, limited);
+	m_size = code.size();
+	void* buffer = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (buffer == MAP_FAILED) throw std::runtime_error("Unable to allocate memory for the generated code\n");
+	std::memcpy(buffer, code.data(), m_size);
+	//The buffer is never writable and executable at the same time
+	if (mprotect(buffer, m_size, PROT_READ | PROT_EXEC) != 0) {
+		munmap(buffer, m_size);
+		throw std::runtime_error("Unable to make the generated code executable\n");
+	}
+	m_code = static_cast<unsigned char*>(buffer);
+}
+
+BFJit::~BFJit() {
+	if (m_code) munmap(m_code, m_size);
+}
+
+bool BFJit::checked() const throw() {
+	return m_checked;
+}
+
+bool BFJit::limited() const throw() {
+	return m_limited;
+}
+
+size_t BFJit::reach() const throw() {
+	return m_reach;
+}
+
+static void start_budget(BFJit::Context& context, BFBudget* budget) {
+	context.budget = budget;
+	context.left = budget ? budget->left() : ULLONG_MAX;
+}
+
+static void end_budget(BFJit::Context const& context) {
+	if (context.budget) context.budget->set_left(context.left);
+}
+
+size_t BFJit::run(std::vector<unsigned char>& cells, size_t cell, BFOutput& out, BFInput& in, BFBudget* budget) const {
+	Context context;
+	context.begin = cells.data();
+	context.end = context.begin + cells.size();
+	context.cells = &cells;
+	context.in = &in;
+	context.out = &out;
+	start_budget(context, budget);
+	int stop = setjmp(context.error);
+	if (stop == 1) throw tape_out_of_bounds(context.bad_cell);
+	if (stop == 2) return context.stopped - context.begin;
+	if (stop == 3) std::rethrow_exception(context.failure);
+
+	typedef unsigned char* (*Function)(Context*, unsigned char*);
+	unsigned char* last = reinterpret_cast<Function>(m_code)(&context, context.begin + cell);
+	end_budget(context);
+	return last - context.begin;
+}
+
+unsigned char* BFJit::run(unsigned char* cell, BFOutput& out, BFInput& in, BFBudget* budget) const {
+	//The unchecked code never uses the tape bounds
+	Context context;
+	context.begin = nullptr;
+	context.end = nullptr;
+	context.cells = nullptr;
+	context.in = &in;
+	context.out = &out;
+	start_budget(context, budget);
+	int stop = setjmp(context.error);
+	if (stop == 3) std::rethrow_exception(context.failure);
+	if (stop == 2) return context.stopped;
+
+	typedef unsigned char* (*Function)(Context*, unsigned char*);
+	unsigned char* last = reinterpret_cast<Function>(m_code)(&context, cell);
+	end_budget(context);
+	return last;
+}
+
+#else
+
+bool BFJit::supported() throw() {
+	return false;
+}
+
+BFJit::BFJit(BFProgram const& program, bool const& checked, bool const& limited) :
+	m_code(nullptr),
+	m_size(0),
+	m_checked(checked),
+	m_limited(limited),
+	m_reach(program.reach()) {
+	throw std::runtime_error("The JIT is only available on x86-64\n");
+}
+
+BFJit::~BFJit() {}
+
+bool BFJit::checked() const throw() {
+	return m_checked;
+}
+
+bool BFJit::limited() const throw() {
+	return m_limited;
+}
+
+size_t BFJit::reach() const throw() {
+	return m_reach;
+}
+
+size_t BFJit::run(std::vector<unsigned char>&, size_t cell, BFOutput&, BFInput&, BFBudget*) const {
+	return cell;
+}
+
+unsigned char* BFJit::run(unsigned char* cell, BFOutput&, BFInput&, BFBudget*) const {
+	return cell;
+}
+
+#endif
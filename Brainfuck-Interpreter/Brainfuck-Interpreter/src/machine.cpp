@@ -0,0 +1,62 @@
+#include "machine.h"
+
+#include "bfexception.h"
+#include "prefix.h"
+
+template<class Code>
+static size_t run_on_spans(BFMachine& machine, Code const& code, char const* input, size_t const& input_size,
+						   char* output, size_t const& capacity) {
+	BFInput in(input, input_size);
+	BFOutput out(output, capacity);
+	machine.run(code, in, out);
+	out.flush();
+	if (out.fail()) throw output_overflow(capacity);
+	return out.count();
+}
+
+BFMachine::BFMachine(TapeKind const& kind, size_t const& size, unsigned int const& cell_bits,
+					 bool const& negative_cells) :
+	m_tape(create_tape(kind, size, cell_bits, negative_cells)),
+	m_prefix(nullptr) {};
+
+size_t BFMachine::run(BFProgram const& program, char const* input, size_t const& input_size,
+					  char* output, size_t const& capacity) {
+	return run_on_spans(*this, program, input, input_size, output, capacity);
+}
+
+size_t BFMachine::run(BFJit const& jit, char const* input, size_t const& input_size,
+					  char* output, size_t const& capacity) {
+	return run_on_spans(*this, jit, input, input_size, output, capacity);
+}
+
+void BFMachine::run(BFProgram const& program, BFInput& in, BFOutput& out) {
+	start(out);
+	if (m_budget) m_budget->start();
+	m_tape->run(program, in, out);
+}
+
+void BFMachine::run(BFJit const& jit, BFInput& in, BFOutput& out) {
+	start(out);
+	if (m_budget) m_budget->start();
+	m_tape->run(jit, in, out);
+}
+
+void BFMachine::set_limits(BFLimits const& limits) {
+	m_budget.reset(limits.empty() ? nullptr : new BFBudget(limits));
+	m_tape->set_budget(m_budget.get());
+}
+
+void BFMachine::set_prefix(BFPrefix const* prefix) throw() {
+	m_prefix = prefix;
+}
+
+void BFMachine::start(BFOutput& out) {
+	m_tape->clear();
+	if (!m_prefix) return;
+	restore_prefix(*m_prefix, *m_tape);
+	out.write(m_prefix->output.data(), m_prefix->output.size());
+}
+
+BFTape const& BFMachine::tape() const throw() {
+	return *m_tape;
+}
@@ -1,6 +1,11 @@
 #include <iostream>
+#include <new>
 #include "interpreter.h"
 #include "args.h"
+#include "bfexception.h"
+
+//Exit status of a program stopped by its limits, so that it is not taken for a finished one
+const int LIMIT_EXCEEDED_STATUS = 3;
 
 int main(int argc, char* argv[]) {
 	BFInterpreter interpreter;
@@ -10,10 +15,17 @@ int main(int argc, char* argv[]) {
 	}
 	catch (std::invalid_argument e) {
 		std::cout << e.what();
-		std::cout << "The command must be run like this:\n" << argv[0] << "[-h] [-f 'file path' | -c | -b 'code']\n";
+		std::cout << "The command must be run like this:\n" << argv[0] << "[-h] [-f 'file path' | -c | -b 'code'] [-O 'optimizations'] [-j] [-o 'output file'] [-t 'tape' [-s 'cells'] [-n]] [-w 'bits'] [-i] [-l 'list file'] [-d 'delimiter'] [-p 'threads'] [-k] [--profile 'report file'] [--max-instructions 'count'] [--timeout 'seconds'] [--checkpoint 'file' [--checkpoint-every 'seconds']] [--resume 'file'] [--cache 'directory'] [--parallel] [--metrics 'file']\n";
+	}
+	catch (limit_exceeded const& e) {
+		std::cerr << e.what();
+		return LIMIT_EXCEEDED_STATUS;
 	}
 	catch (std::runtime_error e) {
 		std::cout << e.what();
 	}
+	catch (std::bad_alloc const&) {
+		std::cout << "Not enough memory to run the program\n";
+	}
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,84 @@
+#include "metrics.h"
+
+#include <cstring>
+#include <iomanip>
+
+//---MONITOR---
+
+volatile std::sig_atomic_t BFMetrics::s_requested = 0;
+
+BFMetrics::BFMetrics(BFProgram const& program, BFBudget* budget) :
+	m_loop_instructions(program.size(), 0),
+	m_outside_instructions(program.size() + 1, 0),
+	m_instructions(0),
+	m_outside(0),
+	m_iterations(0),
+	m_budget(budget) {
+	std::vector<Instruction> const& code = program.instructions();
+	//'[' of the loops around the instruction
+	std::vector<size_t> loops;
+	for (size_t i(0); i != code.size(); ++i) {
+		//The '[' runs in the loop around it and the ']' in its own loop
+		if (code[i].op == OpCode::CLOSE) loops.pop_back();
+		m_outside_instructions[i + 1] = m_outside_instructions[i];
+		if (code[i].op == OpCode::CLOSE) ++m_loop_instructions[code[i].arg];
+		else if (!loops.empty()) ++m_loop_instructions[loops.back()];
+		else ++m_outside_instructions[i + 1];
+		if (code[i].op == OpCode::OPEN) loops.push_back(i);
+	}
+}
+
+void BFMetrics::on_signal(int) {
+	s_requested = 1;
+}
+
+void BFMetrics::install() {
+	clear();
+	struct sigaction action;
+	std::memset(&action, 0, sizeof(action));
+	action.sa_handler = &on_signal;
+	sigemptyset(&action.sa_mask);
+	//A read waiting for input is interrupted so that the metrics are written,
+	//the writes go on
+	action.sa_flags = 0;
+	sigaction(SIGUSR1, &action, nullptr);
+}
+
+void BFMetrics::uninstall() {
+	std::signal(SIGUSR1, SIG_DFL);
+}
+
+void BFMetrics::clear() throw() {
+	s_requested = 0;
+}
+
+bool BFMetrics::requested() throw() {
+	return s_requested != 0;
+}
+
+void BFMetrics::reached(size_t const& instruction) throw() {
+	m_outside = m_outside_instructions[instruction];
+}
+
+unsigned long long BFMetrics::instructions() const throw() {
+	return m_instructions + m_outside;
+}
+
+unsigned long long BFMetrics::iterations() const throw() {
+	return m_iterations;
+}
+
+//---REPORT---
+
+void write_metrics(std::ostream& out, BFMetricsReport const& report) {
+	out << "{\"running\":" << (report.running ? "true" : "false")
+		<< ",\"instructions\":" << report.instructions
+		<< ",\"loop_iterations\":" << report.iterations
+		<< ",\"input_bytes\":" << report.input
+		<< ",\"output_bytes\":" << report.output
+		<< ",\"tape_cells\":" << report.cells
+		<< std::fixed << std::setprecision(6)
+		<< ",\"seconds\":{\"load\":" << report.load_seconds
+		<< ",\"compile\":" << report.compile_seconds
+		<< ",\"execute\":" << report.execute_seconds << "}}\n";
+}
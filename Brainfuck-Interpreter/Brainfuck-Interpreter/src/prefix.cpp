@@ -0,0 +1,118 @@
+#include "prefix.h"
+
+#include "analysis.h"
+#include "bfexception.h"
+#include <memory>
+#include <stdexcept>
+
+const unsigned long long PREFIX_INSTRUCTIONS = 1000000000;
+const double PREFIX_SECONDS = 1;
+const size_t PREFIX_OUTPUT = 1 << 20;
+const size_t PREFIX_CELLS = 1 << 20;
+
+//Instructions from first to last, excluded, as a program of their own, no
+//loop may cross its ends
+static BFProgram slice(BFProgram const& program, size_t const& first, size_t const& last) {
+	std::vector<Instruction> instructions(program.instructions().begin() + first, program.instructions().begin() + last);
+	std::vector<size_t> sources(program.sources().begin() + first, program.sources().begin() + last);
+	for (Instruction& action : instructions)
+		if (action.op == OpCode::OPEN || action.op == OpCode::CLOSE) action.arg -= static_cast<int>(first);
+	BFBounds bounds = { false, 0, 0, 0 };
+	if (program.optimization() & Optimization::bounds) bounds = BFAnalysis(instructions).program();
+	size_t const source_size = sources.empty() ? 0 : sources.back() + 1;
+	return BFProgram(instructions, sources, program.optimization(), bounds, source_size);
+}
+
+//Ends of the parts of the program run one after the other by the prefix,
+//each one ends with an outermost loop, the last one ends before the first
+//instruction or loop reading input
+static std::vector<size_t> prefix_parts(std::vector<Instruction> const& code) {
+	std::vector<size_t> ends;
+	size_t i(0);
+	while (i != code.size()) {
+		//A RESERVE goes with the loop after it
+		size_t const open = code[i].op == OpCode::RESERVE ? i + 1 : i;
+		size_t const end = code[open].op == OpCode::OPEN ? code[open].arg + 1 : i + 1;
+		bool reads(false);
+		for (size_t j(i); j != end; ++j)
+			if (code[j].op == OpCode::INPUT) reads = true;
+		if (reads) break;
+		i = end;
+		if (code[open].op == OpCode::OPEN) ends.push_back(i);
+	}
+	if (i != 0 && (ends.empty() || ends.back() != i)) ends.push_back(i);
+	return ends;
+}
+
+BFPrefix evaluate_prefix(BFProgram const& program, unsigned int const& cell_bits, unsigned long long const& instructions) {
+	BFPrefix prefix;
+	prefix.cell_bits = cell_bits;
+	std::vector<size_t> const ends = prefix_parts(program.instructions());
+	if (ends.empty()) return prefix;
+
+	//Only the pages of the cells used take memory
+	std::unique_ptr<BFTape> tape(create_tape(TapeKind::mmap, PREFIX_CELLS, cell_bits));
+	BFLimits limits;
+	limits.instructions = instructions;
+	limits.seconds = PREFIX_SECONDS;
+	BFBudget budget(limits);
+	tape->set_budget(&budget);
+	BFInput in(nullptr, 0);
+	std::string output(PREFIX_OUTPUT, '\0');
+	std::unique_ptr<BFOutput> out(new BFOutput(&output[0], output.size()));
+	size_t begin(0);
+	bool stopped(false);
+	for (size_t end : ends) {
+		try {
+			tape->run(slice(program, begin, end), in, *out);
+		}
+		catch (std::exception const&) {
+			//Out of the tape, of the instructions, of the time or of memory
+			stopped = true;
+		}
+		out->flush();
+		if (stopped || out->fail()) {
+			stopped = true;
+			break;
+		}
+		begin = end;
+	}
+	tape->set_budget(nullptr);
+	//The part that stopped left the tape halfway, the parts before it are run again
+	if (stopped && begin != 0) {
+		tape->clear();
+		out.reset(new BFOutput(&output[0], output.size()));
+		tape->run(slice(program, 0, begin), in, *out);
+		out->flush();
+	}
+	if (begin == 0) return prefix;
+
+	prefix.instruction = begin;
+	prefix.position = tape->position();
+	prefix.reach = tape->extent();
+	for (size_t cell(0); cell != prefix.reach; ++cell) {
+		unsigned long const value = tape->value(cell);
+		if (value != 0) prefix.cells.push_back({ static_cast<long>(cell), value });
+	}
+	prefix.output.assign(output, 0, out->count());
+	return prefix;
+}
+
+BFProgram rest_of_prefix(BFProgram const& program) {
+	return slice(program, program.prefix().instruction, program.size());
+}
+
+bool restore_prefix(BFPrefix const& prefix, BFTape& tape) {
+	try {
+		//A tape too short for the prefix would have stopped it
+		if (prefix.reach != 0) tape.set_value(static_cast<long>(prefix.reach) - 1, 0);
+		for (std::pair<long, unsigned long> const& cell : prefix.cells)
+			tape.set_value(cell.first, cell.second);
+		tape.seek(prefix.position);
+	}
+	catch (tape_out_of_bounds const&) {
+		tape.clear();
+		return false;
+	}
+	return true;
+}
@@ -0,0 +1,148 @@
+#include "profile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <string>
+
+//Line and column of the places of a source, both starting at 1
+class SourceLines
+{
+private:
+	std::vector<size_t> m_starts;
+
+public:
+	SourceLines(char const* first, char const* last) :
+		m_starts(1, 0) {
+		for (char const* read = first; read != last; ++read)
+			if (*read == '\n') m_starts.push_back(read - first + 1);
+	}
+
+	std::string place(size_t const& source) const {
+		size_t line = std::upper_bound(m_starts.begin(), m_starts.end(), source) - m_starts.begin();
+		std::stringstream ss;
+		ss << line << ':' << source - m_starts[line - 1] + 1;
+		return ss.str();
+	}
+};
+
+static std::string describe(Instruction const& action) {
+	std::stringstream ss;
+	switch (action.op) {
+	case OpCode::ADD:
+		ss << (action.arg < 0 ? '-' : '+') << std::abs(action.arg);
+		break;
+	case OpCode::MOVE:
+		ss << (action.arg < 0 ? '<' : '>') << std::abs(action.arg);
+		break;
+	case OpCode::OPEN:
+		ss << '[';
+		break;
+	case OpCode::CLOSE:
+		ss << ']';
+		break;
+	case OpCode::INPUT:
+		ss << ',';
+		break;
+	case OpCode::OUTPUT:
+		ss << '.';
+		break;
+	case OpCode::CLEAR:
+		ss << "clear";
+		break;
+	case OpCode::SCAN:
+		ss << "scan " << (action.arg < 0 ? '<' : '>') << std::abs(action.arg);
+		break;
+	case OpCode::MUL:
+		ss << "mul " << action.arg << " to " << std::showpos << action.offset;
+		break;
+	case OpCode::RESERVE:
+		ss << "reserve " << std::showpos << action.arg << ' ' << action.offset;
+		break;
+	}
+	//The instructions using a cell at an offset of the pointer
+	if (action.offset != 0 && action.op != OpCode::MUL && action.op != OpCode::RESERVE)
+		ss << " at " << std::showpos << action.offset;
+	return ss.str();
+}
+
+static double percent(unsigned long long const& part, unsigned long long const& total) {
+	return total == 0 ? 0 : 100.0 * part / total;
+}
+
+BFProfile::BFProfile(BFProgram const& program) :
+	m_counts(program.size(), 0) {};
+
+std::vector<unsigned long long> const& BFProfile::counts() const throw() {
+	return m_counts;
+}
+
+unsigned long long BFProfile::total() const throw() {
+	return std::accumulate(m_counts.begin(), m_counts.end(), 0ULL);
+}
+
+void BFProfile::write_report(std::ostream& out, BFProgram const& program, char const* first, char const* last) const {
+	std::vector<Instruction> const& code = program.instructions();
+	SourceLines const lines(first, last);
+	unsigned long long const executed = total();
+	out << "Instructions executed: " << executed << "\n\n";
+
+	std::vector<size_t> order;
+	for (size_t i(0); i != code.size(); ++i)
+		if (m_counts[i] != 0) order.push_back(i);
+	std::stable_sort(order.begin(), order.end(), [&](size_t const& a, size_t const& b) {
+		return m_counts[a] > m_counts[b];
+	});
+	out << std::setw(20) << "executions" << std::setw(8) << "%" << "  " << std::left
+		<< std::setw(12) << "line:col" << "instruction\n" << std::right;
+	for (size_t i : order)
+		out << std::setw(20) << m_counts[i]
+			<< std::fixed << std::setprecision(2) << std::setw(8) << percent(m_counts[i], executed) << "  "
+			<< std::left << std::setw(12) << lines.place(program.sources()[i]) << describe(code[i]) << '\n' << std::right;
+
+	//Instructions run inside each loop, brackets included
+	std::vector<unsigned long long> before(code.size() + 1, 0);
+	std::partial_sum(m_counts.begin(), m_counts.end(), before.begin() + 1);
+	order.clear();
+	for (size_t i(0); i != code.size(); ++i)
+		if (code[i].op == OpCode::OPEN && m_counts[i] != 0) order.push_back(i);
+	auto inside = [&](size_t const& open) {
+		return before[code[open].arg + 1] - before[open + 1];
+	};
+	std::stable_sort(order.begin(), order.end(), [&](size_t const& a, size_t const& b) {
+		return inside(a) > inside(b);
+	});
+	out << '\n' << std::left << std::setw(12) << "loop" << std::right << std::setw(16) << "entries"
+		<< std::setw(20) << "iterations" << std::setw(14) << "average trip"
+		<< std::setw(20) << "instructions" << std::setw(8) << "%" << '\n';
+	for (size_t i : order) {
+		unsigned long long const iterations = m_counts[code[i].arg];
+		out << std::left << std::setw(12) << lines.place(program.sources()[i]) << std::right
+			<< std::setw(16) << m_counts[i] << std::setw(20) << iterations
+			<< std::fixed << std::setprecision(2) << std::setw(14) << static_cast<double>(iterations) / m_counts[i]
+			<< std::setw(20) << inside(i) << std::setw(8) << percent(inside(i), executed) << '\n';
+	}
+}
+
+void BFProfile::write_folded(std::ostream& out, BFProgram const& program, char const* first, char const* last) const {
+	std::vector<Instruction> const& code = program.instructions();
+	SourceLines const lines(first, last);
+	//Frame of each loop, indexed by its '[', the whole program is the last one
+	std::vector<std::string> frames(code.size() + 1);
+	std::vector<unsigned long long> self(code.size() + 1, 0);
+	frames.back() = "program";
+	std::vector<size_t> loops(1, code.size());
+	for (size_t i(0); i != code.size(); ++i) {
+		//The '[' belongs to the enclosing frame and the ']' to the loop
+		self[loops.back()] += m_counts[i];
+		if (code[i].op == OpCode::OPEN) {
+			frames[i] = frames[loops.back()] + ";loop@" + lines.place(program.sources()[i]);
+			loops.push_back(i);
+		}
+		else if (code[i].op == OpCode::CLOSE) loops.pop_back();
+	}
+	for (size_t i(0); i != frames.size(); ++i)
+		if (self[i] != 0) out << frames[i] << ' ' << self[i] << '\n';
+}
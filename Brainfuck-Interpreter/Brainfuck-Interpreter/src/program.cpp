@@ -0,0 +1,334 @@
+#include "program.h"
+
+#include "analysis.h"
+#include "bfexception.h"
+#include <array>
+#include <climits>
+#include <cstdlib>
+#include <map>
+#include <utility>
+
+//---SOURCE FILTERING---
+
+//Class of each byte of the source, any byte that is not an instruction is a comment
+enum Token : unsigned char { COMMENT, PLUS, MINUS, RIGHT, LEFT, DOT, COMMA, OPEN_BRACKET, CLOSE_BRACKET };
+
+static std::array<Token, 256> make_token_table() {
+	std::array<Token, 256> table;
+	table.fill(COMMENT);
+	table['+'] = PLUS;
+	table['-'] = MINUS;
+	table['>'] = RIGHT;
+	table['<'] = LEFT;
+	table['.'] = DOT;
+	table[','] = COMMA;
+	table['['] = OPEN_BRACKET;
+	table[']'] = CLOSE_BRACKET;
+	return table;
+}
+
+static const std::array<Token, 256> TOKEN = make_token_table();
+
+bool is_brainfuck_char(char const& c) throw() {
+	return TOKEN[static_cast<unsigned char>(c)] != COMMENT;
+}
+
+//---COMPILATION---
+
+BFProgram::BFProgram() :
+	m_optimization(Optimization::all),
+	m_fold_barrier(0),
+	m_source_size(0),
+	m_bounds{ false, 0, 0, 0 } {};
+
+BFProgram::BFProgram(std::string const& code, Optimization const& optimization) :
+	m_optimization(optimization),
+	m_fold_barrier(0),
+	m_source_size(0),
+	m_bounds{ false, 0, 0, 0 } {
+	compile(code);
+};
+
+BFProgram::BFProgram(char const* first, char const* last, Optimization const& optimization) :
+	m_optimization(optimization),
+	m_fold_barrier(0),
+	m_source_size(0),
+	m_bounds{ false, 0, 0, 0 } {
+	compile(first, last);
+};
+
+BFProgram::BFProgram(std::vector<Instruction> const& instructions, std::vector<size_t> const& sources,
+					 Optimization const& optimization, BFBounds const& bounds, size_t const& source_size) :
+	m_instructions(instructions),
+	m_sources(sources),
+	m_optimization(optimization),
+	m_fold_barrier(instructions.size()),
+	m_source_size(source_size),
+	m_bounds(bounds) {};
+
+void BFProgram::compile(std::string const& code) {
+	compile(code.data(), code.data() + code.size());
+}
+
+void BFProgram::compile(char const* first, char const* last) {
+	m_instructions.clear();
+	m_sources.clear();
+	m_open_loop.clear();
+	m_source_size = 0;
+	m_prefix = BFPrefix();
+	append(first, last);
+	if (!m_open_loop.empty()) throw unbalanced_brackets('[', m_sources[m_open_loop.back()]);
+	if (m_optimization & Optimization::offsets) offset_moves();
+	if (m_optimization & Optimization::bounds) reserve_loops();
+}
+
+void BFProgram::append(char const* first, char const* last) {
+	m_fold_barrier = m_instructions.size();
+	m_bounds.bounded = false;
+	size_t const base = m_source_size;
+	for (char const* read = first; read != last; ++read) {
+		size_t const source = base + (read - first);
+		switch (TOKEN[static_cast<unsigned char>(*read)]) {
+		case COMMENT:
+			break;
+		case PLUS:
+			fold(OpCode::ADD, 1, source);
+			break;
+		case MINUS:
+			fold(OpCode::ADD, -1, source);
+			break;
+		case RIGHT:
+			fold(OpCode::MOVE, 1, source);
+			break;
+		case LEFT:
+			fold(OpCode::MOVE, -1, source);
+			break;
+		case DOT:
+			push({ OpCode::OUTPUT, 0, 0 }, source);
+			break;
+		case COMMA:
+			push({ OpCode::INPUT, 0, 0 }, source);
+			break;
+		case OPEN_BRACKET:
+			m_open_loop.push_back(m_instructions.size());
+			push({ OpCode::OPEN, 0, 0 }, source);
+			break;
+		case CLOSE_BRACKET: {
+			if (m_open_loop.empty()) throw unbalanced_brackets(']', source);
+			size_t const open = m_open_loop.back();
+			//A loop opened by a previous code may be running, it stays a loop
+			if (open < m_fold_barrier || !replace_loop(open)) {
+				//Both brackets point to each other
+				m_instructions[open].arg = m_instructions.size();
+				push({ OpCode::CLOSE, static_cast<int>(open), 0 }, source);
+			}
+			m_open_loop.pop_back();
+			break;
+		}
+		}
+	}
+	m_source_size += last - first;
+	for (size_t open : m_open_loop)
+		m_instructions[open].arg = m_instructions.size() - 1;
+}
+
+std::vector<size_t> const& BFProgram::open_loops() const throw() {
+	return m_open_loop;
+}
+
+Optimization BFProgram::optimization() const throw() {
+	return m_optimization;
+}
+
+void BFProgram::set_optimization(Optimization const& optimization) throw() {
+	m_optimization = optimization;
+}
+
+std::vector<Instruction> const& BFProgram::instructions() const throw() {
+	return m_instructions;
+}
+
+std::vector<size_t> const& BFProgram::sources() const throw() {
+	return m_sources;
+}
+
+BFBounds const& BFProgram::bounds() const throw() {
+	return m_bounds;
+}
+
+BFPrefix const& BFProgram::prefix() const throw() {
+	return m_prefix;
+}
+
+void BFProgram::set_prefix(BFPrefix const& prefix) {
+	m_prefix = prefix;
+}
+
+size_t BFProgram::reach() const throw() {
+	size_t reach(0);
+	for (Instruction const& action : m_instructions) {
+		int distance(0);
+		if (action.op == OpCode::MOVE || action.op == OpCode::SCAN) distance = action.arg;
+		else if (action.op != OpCode::OPEN && action.op != OpCode::CLOSE && action.op != OpCode::RESERVE) distance = action.offset;
+		if (static_cast<size_t>(std::abs(distance)) > reach) reach = std::abs(distance);
+	}
+	return reach;
+}
+
+size_t BFProgram::size() const throw() {
+	return m_instructions.size();
+}
+
+bool BFProgram::empty() const throw() {
+	return m_instructions.empty();
+}
+
+void BFProgram::push(Instruction const& action, size_t const& source) {
+	m_instructions.push_back(action);
+	m_sources.push_back(source);
+}
+
+void BFProgram::fold(OpCode const& op, int const& arg, size_t const& source) {
+	//Merge the action with the previous one if they are of the same kind
+	if ((m_optimization & Optimization::fold)
+		&& m_instructions.size() > m_fold_barrier && m_instructions.back().op == op) {
+		m_instructions.back().arg += arg;
+		//The actions cancelled each other
+		if (m_instructions.back().arg == 0) {
+			m_instructions.pop_back();
+			m_sources.pop_back();
+		}
+	}
+	else push({ op, arg, 0 }, source);
+}
+
+bool BFProgram::replace_loop(size_t const& open) {
+	if (open + 1 == m_instructions.size()) return false;
+	//Sum what the body of the loop does to each cell, relative to the pointed cell
+	std::map<int, int> added;
+	int offset(0);
+	bool moves_only(true);
+	for (size_t i(open + 1); i != m_instructions.size(); ++i) {
+		Instruction const& action = m_instructions[i];
+		if (action.op == OpCode::MOVE) offset += action.arg;
+		else if (action.op == OpCode::ADD) {
+			added[offset] += action.arg;
+			moves_only = false;
+		}
+		//Input, output or inner loop, it is not an idiom
+		else return false;
+	}
+
+	std::vector<Instruction> replacement;
+	if (moves_only) {
+		//'[>]', '[<<]'... look for the next zero cell
+		if (!(m_optimization & Optimization::scan) || offset == 0) return false;
+		replacement.push_back({ OpCode::SCAN, offset, 0 });
+	}
+	else {
+		//The loop must end where it started and count the pointed cell down to zero
+		if (offset != 0) return false;
+		int counter = added[0];
+		added.erase(0);
+		bool touch_other = false;
+		for (auto const& cell : added)
+			if (cell.second != 0) touch_other = true;
+
+		if (!touch_other) {
+			//'[-]' or '[+]' clear the cell
+			if (!(m_optimization & Optimization::clear) || (counter != 1 && counter != -1)) return false;
+		}
+		else {
+			//'[->+>++<<]' add the cell times the factor to the other cells
+			if (!(m_optimization & Optimization::multiply) || counter != -1) return false;
+			for (auto const& cell : added)
+				if (cell.second != 0) replacement.push_back({ OpCode::MUL, cell.second, cell.first });
+		}
+		replacement.push_back({ OpCode::CLEAR, 0, 0 });
+	}
+	size_t const source = m_sources[open];
+	m_instructions.resize(open);
+	m_sources.resize(open);
+	for (Instruction const& action : replacement)
+		push(action, source);
+	return true;
+}
+
+void BFProgram::offset_moves() {
+	std::vector<Instruction> instructions;
+	std::vector<size_t> sources;
+	//New index of each bracket, for their jumps
+	std::vector<size_t> moved(m_instructions.size());
+	//Moves not made yet, the instructions use the cell at this offset instead
+	int pending(0);
+	size_t pending_source(0);
+	for (size_t i(0); i != m_instructions.size(); ++i) {
+		Instruction action = m_instructions[i];
+		switch (action.op) {
+		case OpCode::MOVE:
+			if (pending == 0) pending_source = m_sources[i];
+			pending += action.arg;
+			continue;
+		case OpCode::ADD:
+		case OpCode::INPUT:
+		case OpCode::OUTPUT:
+		case OpCode::CLEAR:
+			action.offset = pending;
+			break;
+		default:
+			//The brackets, scans and multiplications work from the pointed cell
+			if (pending != 0) {
+				instructions.push_back({ OpCode::MOVE, pending, 0 });
+				sources.push_back(pending_source);
+				pending = 0;
+			}
+			break;
+		}
+		moved[i] = instructions.size();
+		instructions.push_back(action);
+		sources.push_back(m_sources[i]);
+	}
+	if (pending != 0) {
+		instructions.push_back({ OpCode::MOVE, pending, 0 });
+		sources.push_back(pending_source);
+	}
+	for (Instruction& action : instructions)
+		if (action.op == OpCode::OPEN || action.op == OpCode::CLOSE) action.arg = static_cast<int>(moved[action.arg]);
+	m_instructions.swap(instructions);
+	m_sources.swap(sources);
+}
+
+void BFProgram::reserve_loops() {
+	BFAnalysis const analysis(m_instructions);
+	m_bounds = analysis.program();
+	std::vector<Instruction> instructions;
+	std::vector<size_t> sources;
+	//New index of each instruction, for the jumps of the brackets
+	std::vector<size_t> moved(m_instructions.size());
+	//The ']' of the loop being run without checks
+	size_t reserved_end(0);
+	bool reserved(false);
+	for (size_t i(0); i != m_instructions.size(); ++i) {
+		Instruction const& action = m_instructions[i];
+		if (!reserved && action.op == OpCode::OPEN) {
+			//Only the outermost balanced loops are reserved, a loop that doesn't
+			//move the pointer only uses its cell which always exists
+			BFBounds const& loop = analysis.loop(i);
+			if (loop.bounded && (loop.lowest != 0 || loop.highest != 0)
+				&& loop.lowest >= INT_MIN && loop.highest <= INT_MAX) {
+				instructions.push_back({ OpCode::RESERVE, static_cast<int>(loop.lowest), static_cast<int>(loop.highest) });
+				sources.push_back(m_sources[i]);
+				reserved_end = action.arg;
+				reserved = true;
+			}
+		}
+		moved[i] = instructions.size();
+		instructions.push_back(action);
+		sources.push_back(m_sources[i]);
+		if (reserved && i == reserved_end) reserved = false;
+	}
+	for (Instruction& action : instructions)
+		if (action.op == OpCode::OPEN || action.op == OpCode::CLOSE) action.arg = static_cast<int>(moved[action.arg]);
+	m_instructions.swap(instructions);
+	m_sources.swap(sources);
+}
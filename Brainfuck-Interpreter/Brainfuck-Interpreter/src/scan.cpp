@@ -0,0 +1,119 @@
+#include "scan.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BF_SCAN_X86_64
+#include <immintrin.h>
+#endif
+
+//---SCALAR SEARCH---
+
+static bool is_zero(char const* cell, size_t const& width) {
+	for (size_t byte(0); byte != width; ++byte)
+		if (cell[byte] != 0) return false;
+	return true;
+}
+
+//Cell by cell, for the long strides and the ends of the tape too short for a vector
+static long scalar_search(char const* first, long const& count, long cell, long const& stride, size_t const& width) {
+	while (cell >= 0 && cell < count && !is_zero(first + cell * width, width)) cell += stride;
+	return cell;
+}
+
+#ifdef BF_SCAN_X86_64
+
+//---VECTOR SEARCH---
+
+//Each vector gives a mask with the bit of each byte of the cells equal to zero
+struct Sse2 {
+	static const long SIZE = 16;
+
+	static unsigned int zeros(char const* bytes, size_t const& width) {
+		__m128i const cells = _mm_loadu_si128(reinterpret_cast<__m128i const*>(bytes));
+		__m128i const zero = _mm_setzero_si128();
+		if (width == 1) return _mm_movemask_epi8(_mm_cmpeq_epi8(cells, zero));
+		if (width == 2) return _mm_movemask_epi8(_mm_cmpeq_epi16(cells, zero));
+		return _mm_movemask_epi8(_mm_cmpeq_epi32(cells, zero));
+	}
+};
+
+struct Avx2 {
+	static const long SIZE = 32;
+
+	__attribute__((target("avx2")))
+	static unsigned int zeros(char const* bytes, size_t const& width) {
+		__m256i const cells = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(bytes));
+		__m256i const zero = _mm256_setzero_si256();
+		if (width == 1) return _mm256_movemask_epi8(_mm256_cmpeq_epi8(cells, zero));
+		if (width == 2) return _mm256_movemask_epi8(_mm256_cmpeq_epi16(cells, zero));
+		return _mm256_movemask_epi8(_mm256_cmpeq_epi32(cells, zero));
+	}
+};
+
+//Each vector loaded holds several of the cells looked at, the mask keeps the
+//first byte of each of them, a strided scan like '[>>>]' looks at every third cell
+//The vector starts on the cell when going right and ends on it when going left
+template<class Vector>
+__attribute__((always_inline))
+static inline long vector_search(char const* first, long const& count, long cell, long const& stride, size_t const& width) {
+	long const distance = stride < 0 ? -stride : stride;
+	//Bytes from a cell looked at to the next one
+	long const step = distance * width;
+	long const looked = Vector::SIZE / step;
+	if (looked < 2) return scalar_search(first, count, cell, stride, width);
+	long const loaded = Vector::SIZE / width;
+	unsigned int mask(0);
+	if (stride > 0) {
+		for (long i(0); i != looked; ++i)
+			mask |= 1u << (i * step);
+		while (cell >= 0 && cell + loaded <= count) {
+			unsigned int const found = Vector::zeros(first + cell * width, width) & mask;
+			if (found) return cell + __builtin_ctz(found) / width;
+			cell += looked * distance;
+		}
+	}
+	else {
+		for (long i(0); i != looked; ++i)
+			mask |= 1u << ((loaded - 1 - i * distance) * width);
+		while (cell - loaded + 1 >= 0 && cell < count) {
+			long const low = cell - loaded + 1;
+			unsigned int const found = Vector::zeros(first + low * width, width) & mask;
+			if (found) return low + (31 - __builtin_clz(found)) / width;
+			cell -= looked * distance;
+		}
+	}
+	//The end of the tape is too close for a whole vector
+	return scalar_search(first, count, cell, stride, width);
+}
+
+static long sse2_search(char const* first, long const& count, long cell, long const& stride, size_t const& width) {
+	return vector_search<Sse2>(first, count, cell, stride, width);
+}
+
+__attribute__((target("avx2")))
+static long avx2_search(char const* first, long const& count, long cell, long const& stride, size_t const& width) {
+	return vector_search<Avx2>(first, count, cell, stride, width);
+}
+
+#endif
+
+//---DISPATCH---
+
+typedef long (*Search)(char const*, long const&, long, long const&, size_t const&);
+
+//Widest vectors the processor running the program has
+static Search choose_search() {
+#ifdef BF_SCAN_X86_64
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return &avx2_search;
+	//SSE2 is part of x86-64
+	return &sse2_search;
+#else
+	return &scalar_search;
+#endif
+}
+
+static const Search SEARCH = choose_search();
+
+long find_zero_bytes(char const* first, char const* last, long const& cell, long const& stride, size_t const& width) {
+	return SEARCH(first, static_cast<long>((last - first) / width), cell, stride, width);
+}
@@ -0,0 +1,56 @@
+#include "source.h"
+
+#include <cerrno>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BFSource::BFSource(std::string const& path) :
+	m_mapping(nullptr),
+	m_size(0) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) throw std::invalid_argument("Invalid path or an error have occured when oppening the file\n");
+	struct stat status;
+	if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0) {
+		void* mapping = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED) {
+			m_mapping = mapping;
+			m_size = status.st_size;
+			//The compiler reads the file once from start to end
+			madvise(m_mapping, m_size, MADV_SEQUENTIAL);
+			close(fd);
+			return;
+		}
+	}
+	char buffer[1 << 16];
+	for (;;) {
+		ssize_t n = read(fd, buffer, sizeof(buffer));
+		if (n < 0 && errno == EINTR) continue;
+		if (n < 0) {
+			close(fd);
+			throw std::invalid_argument("Invalid path or an error have occured when oppening the file\n");
+		}
+		if (n == 0) break;
+		m_content.insert(m_content.end(), buffer, buffer + n);
+	}
+	close(fd);
+	m_size = m_content.size();
+}
+
+BFSource::~BFSource() {
+	if (m_mapping) munmap(m_mapping, m_size);
+}
+
+char const* BFSource::begin() const throw() {
+	return m_mapping ? static_cast<char const*>(m_mapping) : m_content.data();
+}
+
+char const* BFSource::end() const throw() {
+	return begin() + m_size;
+}
+
+size_t BFSource::size() const throw() {
+	return m_size;
+}
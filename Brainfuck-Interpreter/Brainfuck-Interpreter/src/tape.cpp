@@ -0,0 +1,677 @@
+#include "tape.h"
+
+#include "bfexception.h"
+#include "executor.h"
+#include "jit.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <csetjmp>
+#include <csignal>
+#include <mutex>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+//---BFTAPE---
+
+BFTape::BFTape() :
+	m_position(0),
+	m_budget(nullptr) {};
+
+BFTape::~BFTape() {};
+
+long BFTape::position() const throw() {
+	return m_position;
+}
+
+size_t BFTape::reached() const {
+	return size();
+}
+
+std::vector<std::pair<long, long>> BFTape::ranges() const {
+	return { { 0, static_cast<long>(size()) } };
+}
+
+bool BFTape::exists(long const& cell) const {
+	for (std::pair<long, long> const& range : ranges())
+		if (cell >= range.first && cell < range.second) return true;
+	return false;
+}
+
+void BFTape::run_parallel(BFProgram const& program, BFInput& in, BFOutput& out) {
+	run(program, in, out);
+}
+
+void BFTape::set_budget(BFBudget* budget) throw() {
+	m_budget = budget;
+}
+
+void BFTape::check_budget() const {
+	if (m_budget && (m_budget->timeout() || m_budget->exhausted()))
+		throw limit_exceeded(m_budget->timeout(), m_budget->spent(), m_budget->seconds(), m_position);
+}
+
+//Native code able to stop when the tape has a budget
+static void check_limited(BFJit const& jit, BFBudget const* budget) {
+	if (budget && !jit.limited()) throw std::invalid_argument("The native code must be limited to run with a budget\n");
+}
+
+//---VECTORTAPE---
+
+template<typename Cell>
+VectorTape<Cell>::VectorTape() :
+	m_cells(1, 0) {};
+
+template<typename Cell>
+size_t VectorTape<Cell>::size() const throw() {
+	return m_cells.size();
+}
+
+template<typename Cell>
+unsigned long VectorTape<Cell>::value(long const& cell) const {
+	if (cell < 0) throw std::out_of_range("cell out of the tape");
+	return m_cells.at(cell);
+}
+
+template<typename Cell>
+size_t VectorTape<Cell>::extent() const {
+	return m_cells.size();
+}
+
+template<typename Cell>
+void VectorTape<Cell>::set_value(long const& cell, unsigned long const& value) {
+	if (cell < 0) throw tape_out_of_bounds(cell);
+	if (static_cast<size_t>(cell) >= m_cells.size()) m_cells.resize(cell + 1, 0);
+	m_cells[cell] = static_cast<cell_type>(value);
+}
+
+template<typename Cell>
+void VectorTape<Cell>::seek(long const& cell) {
+	if (cell < 0) throw tape_out_of_bounds(cell);
+	if (static_cast<size_t>(cell) >= m_cells.size()) m_cells.resize(cell + 1, 0);
+	m_position = cell;
+}
+
+template<typename Cell>
+void VectorTape<Cell>::clear() {
+	//Shrinking keeps the capacity for the next run
+	m_cells.assign(1, 0);
+	m_position = 0;
+}
+
+template<typename Cell>
+void VectorTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out) {
+	if (reserve_program(program)) {
+		//The pointer never leaves the cells, nothing is checked
+		UncheckedTape<VectorTape> unchecked(*this);
+		if (m_budget) m_position = execute(unchecked, m_position, program.instructions(), in, out, *m_budget);
+		else m_position = execute(unchecked, m_position, program.instructions(), in, out);
+	}
+	else if (m_budget) m_position = execute(*this, m_position, program.instructions(), in, out, *m_budget);
+	else m_position = execute(*this, m_position, program.instructions(), in, out);
+	check_budget();
+}
+
+template<typename Cell>
+void VectorTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile) {
+	m_position = execute(*this, m_position, program.instructions(), in, out, profile);
+}
+
+template<typename Cell>
+size_t VectorTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							 BFCheckpointTrigger& trigger) {
+	size_t next(instruction);
+	m_position = execute(*this, m_position, program.instructions(), in, out, trigger, next);
+	return next;
+}
+
+template<typename Cell>
+size_t VectorTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							 BFLastInstruction& last) {
+	size_t next(instruction);
+	m_position = execute(*this, m_position, program.instructions(), in, out, last, next);
+	return next;
+}
+
+template<typename Cell>
+size_t VectorTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							 BFMetrics& metrics) {
+	size_t next(instruction);
+	m_position = execute(*this, m_position, program.instructions(), in, out, metrics, next);
+	return next;
+}
+
+//The JIT only generates code for 8 bits cells
+template<typename Cell>
+void VectorTape<Cell>::run_native(BFProgram const& program, BFInput& in, BFOutput& out) {
+	if (sizeof(cell_type) == 1 && BFJit::supported()) run(BFJit(program, true, m_budget != nullptr), in, out);
+	else run(program, in, out);
+}
+
+template<typename Cell>
+void VectorTape<Cell>::run_parallel(BFProgram const& program, BFInput& in, BFOutput& out) {
+	//The budget is spent by one thread at a time
+	if (m_budget) return run(program, in, out);
+	std::vector<Instruction> const& code = program.instructions();
+	std::vector<BFLoopGroup> const groups = BFAnalysis(code).independent_loops(code);
+	if (reserve_program(program)) {
+		UncheckedTape<VectorTape> unchecked(*this);
+		m_position = execute_parallel(unchecked, m_position, code, groups, in, out);
+	}
+	else m_position = execute_parallel(*this, m_position, code, groups, in, out);
+}
+
+template<typename Cell>
+void VectorTape<Cell>::run(BFJit const&, BFInput&, BFOutput&) {
+	throw std::invalid_argument("The native code only runs on 8 bits cells\n");
+}
+
+template<>
+void VectorTape<uint8_t>::run(BFJit const& jit, BFInput& in, BFOutput& out) {
+	if (!jit.checked()) throw std::invalid_argument("A vector tape needs checked native code\n");
+	check_limited(jit, m_budget);
+	m_position = jit.run(m_cells, m_position, out, in, m_budget);
+	check_budget();
+}
+
+template<typename Cell>
+bool VectorTape<Cell>::reserve_program(BFProgram const& program) {
+	BFBounds const& bounds = program.bounds();
+	if (!bounds.bounded || m_position + bounds.lowest < 0) return false;
+	size_t const size = m_position + bounds.highest + 1;
+	if (size > m_cells.size()) m_cells.resize(size, 0);
+	return true;
+}
+
+template<typename Cell>
+Cell* VectorTape<Cell>::grow(cell_type* cell, int const& offset) {
+	long index = cell - m_cells.data();
+	if (index + offset < 0) throw tape_out_of_bounds(index + offset);
+	m_cells.resize(index + offset + 1, 0);
+	return m_cells.data() + index;
+}
+
+//---FAULTS IN THE GUARD REGIONS---
+
+//Mapping of the guarded tape whose program is running on this thread
+struct FaultGuard {
+	char const* first;
+	char const* last;
+	char const* address;
+	sigjmp_buf jump;
+};
+
+static thread_local FaultGuard* t_fault_guard = nullptr;
+
+static void on_fault(int signal, siginfo_t* info, void*) {
+	FaultGuard* guard = t_fault_guard;
+	char const* address = static_cast<char const*>(info->si_addr);
+	if (guard && address >= guard->first && address < guard->last) {
+		guard->address = address;
+		siglongjmp(guard->jump, 1);
+	}
+	//Not a fault of a tape, the default action is restored and the fault happens again
+	std::signal(signal, SIG_DFL);
+}
+
+static void install_fault_handler() {
+	static std::once_flag installed;
+	std::call_once(installed, []() {
+		struct sigaction action;
+		std::memset(&action, 0, sizeof(action));
+		action.sa_sigaction = &on_fault;
+		action.sa_flags = SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+		sigaction(SIGSEGV, &action, nullptr);
+		sigaction(SIGBUS, &action, nullptr);
+	});
+}
+
+//Forget the running tape even when the run ends with an exception
+struct FaultGuardScope {
+	explicit FaultGuardScope(FaultGuard* guard) throw() { t_fault_guard = guard; }
+	~FaultGuardScope() { t_fault_guard = nullptr; }
+};
+
+//Run the function, a fault in the mapping is reported as the use of a cell out of the tape
+template<class Function>
+static void run_guarded(char const* mapping, size_t const& mapping_size,
+						char const* cells, size_t const& cell_size, Function const& run) {
+	install_fault_handler();
+	FaultGuard guard;
+	guard.first = mapping;
+	guard.last = mapping + mapping_size;
+	FaultGuardScope scope(&guard);
+	if (sigsetjmp(guard.jump, 1)) {
+		long offset = guard.address - cells;
+		long size = static_cast<long>(cell_size);
+		throw tape_out_of_bounds(offset >= 0 ? offset / size : (offset - size + 1) / size);
+	}
+	run();
+}
+
+//---GUARDEDTAPE---
+
+template<typename Cell>
+const size_t GuardedTape<Cell>::GUARD_SIZE = 64 << 20;
+
+template<typename Cell>
+GuardedTape<Cell>::GuardedTape(size_t const& count, bool const& populate) :
+	m_mapping(nullptr),
+	m_mapping_size(0),
+	m_cells(nullptr),
+	m_count(0),
+	m_used(0),
+	m_populated(populate) {
+	if (count == 0) throw std::invalid_argument("The tape needs at least one cell\n");
+	//The tape is rounded to whole pages, only the left end is exact
+	size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t bytes = (count * sizeof(cell_type) + page - 1) / page * page;
+	m_mapping_size = bytes + 2 * GUARD_SIZE;
+	void* mapping = mmap(nullptr, m_mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mapping == MAP_FAILED) throw std::runtime_error("Unable to reserve memory for the tape\n");
+	m_mapping = static_cast<char*>(mapping);
+	m_cells = reinterpret_cast<cell_type*>(m_mapping + GUARD_SIZE);
+	if (mprotect(m_cells, bytes, PROT_READ | PROT_WRITE) != 0) {
+		munmap(m_mapping, m_mapping_size);
+		throw std::runtime_error("Unable to reserve memory for the tape\n");
+	}
+	m_count = bytes / sizeof(cell_type);
+	//Touch every page now instead of when the program uses them
+	if (populate) std::memset(m_cells, 0, bytes);
+}
+
+template<typename Cell>
+GuardedTape<Cell>::~GuardedTape() {
+	munmap(m_mapping, m_mapping_size);
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::size() const throw() {
+	return m_used + 1;
+}
+
+template<typename Cell>
+unsigned long GuardedTape<Cell>::value(long const& cell) const {
+	if (cell < 0 || static_cast<size_t>(cell) >= m_count) throw std::out_of_range("cell out of the tape");
+	return m_cells[cell];
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::reached() const {
+	if (m_populated) return std::max(extent(), m_used + 1);
+	return std::max(resident(), m_used + 1);
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::extent() const {
+	//Only the pages in memory may hold other values than zero
+	size_t cells = resident();
+	while (cells != 0 && m_cells[cells - 1] == 0) --cells;
+	return std::max(cells, static_cast<size_t>(m_position) + 1);
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::set_value(long const& cell, unsigned long const& value) {
+	if (cell < 0 || static_cast<size_t>(cell) >= m_count) throw tape_out_of_bounds(cell);
+	m_cells[cell] = static_cast<cell_type>(value);
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::seek(long const& cell) {
+	set_position(cell);
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::clear() {
+	//The cells used by the last run are not known, the whole tape is cleared
+	if (m_populated) std::memset(m_cells, 0, m_count * sizeof(cell_type));
+	else madvise(m_cells, m_count * sizeof(cell_type), MADV_DONTNEED);
+	m_position = 0;
+	m_used = 0;
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out) {
+	check_reach(program.reach());
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		if (m_budget) set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out, *m_budget)));
+		else set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out)));
+	});
+	check_budget();
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile) {
+	check_reach(program.reach());
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out, profile)));
+	});
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							  BFCheckpointTrigger& trigger) {
+	check_reach(program.reach());
+	size_t next(instruction);
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out, trigger, next)));
+	});
+	return next;
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							  BFLastInstruction& last) {
+	check_reach(program.reach());
+	size_t next(instruction);
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out, last, next)));
+	});
+	return next;
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							  BFMetrics& metrics) {
+	check_reach(program.reach());
+	size_t next(instruction);
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		set_position(static_cast<long>(execute(*this, m_position, program.instructions(), in, out, metrics, next)));
+	});
+	return next;
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::run_native(BFProgram const& program, BFInput& in, BFOutput& out) {
+	if (sizeof(cell_type) == 1 && BFJit::supported()) run(BFJit(program, false, m_budget != nullptr), in, out);
+	else run(program, in, out);
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::run(BFJit const&, BFInput&, BFOutput&) {
+	throw std::invalid_argument("The native code only runs on 8 bits cells\n");
+}
+
+template<>
+void GuardedTape<uint8_t>::run(BFJit const& jit, BFInput& in, BFOutput& out) {
+	if (jit.checked()) throw std::invalid_argument("A guarded tape needs unchecked native code\n");
+	check_reach(jit.reach());
+	check_limited(jit, m_budget);
+	run_guarded(m_mapping, m_mapping_size, reinterpret_cast<char const*>(m_cells), sizeof(cell_type), [&]() {
+		set_position(jit.run(m_cells + m_position, out, in, m_budget) - m_cells);
+	});
+	check_budget();
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::check_reach(size_t const& reach) const {
+	//A move longer than a guard region could land in memory that is not the tape
+	if (reach * sizeof(cell_type) >= GUARD_SIZE)
+		throw std::runtime_error("The program moves too far at once for a guarded tape\n");
+}
+
+template<typename Cell>
+size_t GuardedTape<Cell>::resident() const {
+	//The pages of the tape get in memory when the program first reads or writes them
+	size_t const page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t const bytes = m_count * sizeof(cell_type);
+	std::vector<unsigned char> resident((bytes + page - 1) / page);
+	size_t end = bytes;
+	if (mincore(m_cells, bytes, resident.data()) == 0) {
+		while (end != 0 && !(resident[(end - 1) / page] & 1)) end -= page;
+	}
+	return std::min(end / sizeof(cell_type), m_count);
+}
+
+template<typename Cell>
+void GuardedTape<Cell>::set_position(long const& position) {
+	//The program may end with the pointer in a guard region without using it
+	if (position < 0 || position >= static_cast<long>(m_count)) throw tape_out_of_bounds(position);
+	m_position = position;
+	if (static_cast<size_t>(m_position) > m_used) m_used = m_position;
+}
+
+//---PAGEDTAPE---
+
+template<typename Cell>
+const long PagedTape<Cell>::PAGE_SIZE;
+
+template<typename Cell>
+const size_t PagedTape<Cell>::BLOCK_SIZE;
+
+//Number of the page of a cell, the pages of the negative cells are negative
+template<typename Cell>
+static long page_number(long const& cell) {
+	long const size = PagedTape<Cell>::PAGE_SIZE;
+	return cell >= 0 ? cell / size : -((-cell - 1) / size) - 1;
+}
+
+template<typename Cell>
+PagedTape<Cell>::PagedTape(bool const& negative) :
+	m_first_page(0),
+	m_page(nullptr),
+	m_page_number(0),
+	m_negative(negative) {
+	point(0);
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::size() const throw() {
+	std::vector<std::pair<long, long>> const cells = ranges();
+	return cells.empty() || cells.back().second < 0 ? 0 : cells.back().second;
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::reached() const {
+	size_t cells(0);
+	for (cell_type const* page : m_pages)
+		if (page) cells += PAGE_SIZE;
+	return cells;
+}
+
+template<typename Cell>
+unsigned long PagedTape<Cell>::value(long const& cell) const {
+	//The cells of the missing pages are zero
+	cell_type const* found = page_cell(cell);
+	return found ? *found : 0;
+}
+
+template<typename Cell>
+std::vector<std::pair<long, long>> PagedTape<Cell>::ranges() const {
+	//The pages following each other make one range
+	std::vector<std::pair<long, long>> cells;
+	for (size_t i(0); i != m_pages.size(); ++i) {
+		if (!m_pages[i]) continue;
+		long const first = (m_first_page + static_cast<long>(i)) * PAGE_SIZE;
+		if (!cells.empty() && cells.back().second == first) cells.back().second += PAGE_SIZE;
+		else cells.push_back({ first, first + PAGE_SIZE });
+	}
+	return cells;
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::extent() const {
+	long cells = static_cast<long>(size());
+	while (cells > 0 && value(cells - 1) == 0) {
+		//A missing page is skipped at once
+		if (!page_cell(cells - 1)) cells = page_number<Cell>(cells - 1) * PAGE_SIZE;
+		else --cells;
+	}
+	return std::max(cells, m_position + 1);
+}
+
+template<typename Cell>
+void PagedTape<Cell>::set_value(long const& cell, unsigned long const& value) {
+	*page_cell(cell, true) = static_cast<cell_type>(value);
+}
+
+template<typename Cell>
+void PagedTape<Cell>::seek(long const& cell) {
+	point(cell);
+	m_position = cell;
+}
+
+template<typename Cell>
+void PagedTape<Cell>::clear() {
+	//Only the pages used are cleared, they go back to the pool
+	for (cell_type* page : m_pages) {
+		if (!page) continue;
+		std::memset(page, 0, PAGE_SIZE * sizeof(cell_type));
+		m_free.push_back(page);
+	}
+	m_pages.clear();
+	m_first_page = 0;
+	m_position = 0;
+	point(0);
+}
+
+template<typename Cell>
+void PagedTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out) {
+	if (m_budget) execute_from(program, 0, in, out, *m_budget);
+	else {
+		NoMonitor monitor;
+		execute_from(program, 0, in, out, monitor);
+	}
+	check_budget();
+}
+
+template<typename Cell>
+void PagedTape<Cell>::run(BFProgram const& program, BFInput& in, BFOutput& out, BFProfile& profile) {
+	execute_from(program, 0, in, out, profile);
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							BFCheckpointTrigger& trigger) {
+	return execute_from(program, instruction, in, out, trigger);
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							BFLastInstruction& last) {
+	return execute_from(program, instruction, in, out, last);
+}
+
+template<typename Cell>
+size_t PagedTape<Cell>::run(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+							BFMetrics& metrics) {
+	return execute_from(program, instruction, in, out, metrics);
+}
+
+template<typename Cell>
+void PagedTape<Cell>::run_native(BFProgram const& program, BFInput& in, BFOutput& out) {
+	run(program, in, out);
+}
+
+template<typename Cell>
+void PagedTape<Cell>::run(BFJit const&, BFInput&, BFOutput&) {
+	throw std::invalid_argument("The native code doesn't run on a paged tape\n");
+}
+
+template<typename Cell>
+Cell* PagedTape<Cell>::turn_page(cell_type* cell) {
+	return point(index(cell));
+}
+
+template<typename Cell>
+Cell const* PagedTape<Cell>::page_cell(long const& cell) const {
+	long const number = page_number<Cell>(cell) - m_first_page;
+	if (number < 0 || number >= static_cast<long>(m_pages.size()) || !m_pages[number]) return nullptr;
+	return m_pages[number] + (cell - page_number<Cell>(cell) * PAGE_SIZE);
+}
+
+template<typename Cell>
+Cell* PagedTape<Cell>::page_cell(long const& cell, bool const& create) {
+	cell_type const* found = static_cast<PagedTape const*>(this)->page_cell(cell);
+	if (found || !create) return const_cast<cell_type*>(found);
+	if (cell < 0 && !m_negative) throw tape_out_of_bounds(cell);
+
+	long const number = page_number<Cell>(cell);
+	if (m_pages.empty()) m_first_page = number;
+	if (number < m_first_page) {
+		//The table grows on the left by at least its size, like on the right
+		size_t const added = std::max(static_cast<size_t>(m_first_page - number), m_pages.size());
+		m_pages.insert(m_pages.begin(), added, nullptr);
+		m_first_page -= static_cast<long>(added);
+	}
+	if (number - m_first_page >= static_cast<long>(m_pages.size())) m_pages.resize(number - m_first_page + 1, nullptr);
+
+	if (m_free.empty()) {
+		//The block is zero
+		m_blocks.emplace_back(new cell_type[BLOCK_SIZE * PAGE_SIZE]());
+		for (size_t i(BLOCK_SIZE); i != 0; --i)
+			m_free.push_back(m_blocks.back().get() + (i - 1) * PAGE_SIZE);
+	}
+	cell_type* page = m_free.back();
+	m_free.pop_back();
+	m_pages[number - m_first_page] = page;
+	return page + (cell - number * PAGE_SIZE);
+}
+
+template<typename Cell>
+Cell* PagedTape<Cell>::point(long const& position) {
+	cell_type* cell = page_cell(position, true);
+	m_page_number = page_number<Cell>(position);
+	m_page = cell - (position - m_page_number * PAGE_SIZE);
+	return cell;
+}
+
+template<typename Cell>
+template<class Monitor>
+size_t PagedTape<Cell>::execute_from(BFProgram const& program, size_t const& instruction, BFInput& in, BFOutput& out,
+									 Monitor& monitor) {
+	std::vector<Instruction> const& code = program.instructions();
+	cell_type* cell = point(m_position);
+	size_t next(instruction);
+	if (execute_range(*this, cell, code.data(), next, code.size(), in, out, monitor, next)) next = code.size();
+	m_position = index(cell);
+	return next;
+}
+
+//---CREATION---
+
+//Default number of cells of the tapes that don't grow
+static const size_t FIXED_TAPE_SIZE = 30000;
+static const size_t MMAP_TAPE_SIZE = static_cast<size_t>(1) << 30;
+
+template<typename Cell>
+static BFTape* create_tape_of(TapeKind const& kind, size_t const& size, bool const& negative_cells) {
+	switch (kind) {
+	case TapeKind::paged:
+		return new PagedTape<Cell>(negative_cells);
+	case TapeKind::fixed:
+		return new GuardedTape<Cell>(size != 0 ? size : FIXED_TAPE_SIZE, true);
+	case TapeKind::mmap:
+		return new GuardedTape<Cell>(size != 0 ? size : MMAP_TAPE_SIZE, false);
+	default:
+		return new VectorTape<Cell>();
+	}
+}
+
+BFTape* create_tape(TapeKind const& kind, size_t const& size, unsigned int const& cell_bits,
+					bool const& negative_cells) {
+	if (negative_cells && kind != TapeKind::paged) throw std::invalid_argument("Only a paged tape can have negative cells\n");
+	switch (cell_bits) {
+	case 8:
+		return create_tape_of<uint8_t>(kind, size, negative_cells);
+	case 16:
+		return create_tape_of<uint16_t>(kind, size, negative_cells);
+	case 32:
+		return create_tape_of<uint32_t>(kind, size, negative_cells);
+	default:
+		throw std::invalid_argument("The cells can only be 8, 16 or 32 bits wide\n");
+	}
+}
+
+template class VectorTape<uint8_t>;
+template class VectorTape<uint16_t>;
+template class VectorTape<uint32_t>;
+template class GuardedTape<uint8_t>;
+template class GuardedTape<uint16_t>;
+template class GuardedTape<uint32_t>;
+template class PagedTape<uint8_t>;
+template class PagedTape<uint16_t>;
+template class PagedTape<uint32_t>;
@@ -0,0 +1,297 @@
+#include "translator.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+//---C TRANSLATION---
+
+const std::string C_INCLUDES = {
+	"/* Generated by BF from brainfuck code */\n"\
+	"#include <stdint.h>\n"\
+	"#include <stdio.h>\n"\
+	"#include <stdlib.h>\n"\
+	"#include <string.h>\n"\
+	"\n"
+};
+
+//Comes after the typedef of the cells
+const std::string C_HEADER = {
+	"static cell* tape;\n"\
+	"static size_t size;\n"\
+	"\n"\
+	"/* Make the cell at index exist, the new cells are zero */\n"\
+	"static void reserve(size_t index) {\n"\
+	"\tsize_t new_size = size * 2 > index ? size * 2 : index + 1;\n"\
+	"\ttape = realloc(tape, new_size * sizeof(cell));\n"\
+	"\tif (!tape) {\n"\
+	"\t\tfputs(\"Unable to grow the tape\\n\", stderr);\n"\
+	"\t\texit(1);\n"\
+	"\t}\n"\
+	"\tmemset(tape + size, 0, (new_size - size) * sizeof(cell));\n"\
+	"\tsize = new_size;\n"\
+	"}\n"\
+	"\n"\
+	"static void out_of_tape(long index) {\n"\
+	"\tfprintf(stderr, \"Cell %ld is out of the tape\\n\", index);\n"\
+	"\texit(1);\n"\
+	"}\n"\
+	"\n"\
+	"int main(void) {\n"\
+	"\tsize_t i = 0;\n"\
+	"\tint c;\n"\
+	"\tsize = 1;\n"\
+	"\ttape = calloc(1, sizeof(cell));\n"
+};
+
+const std::string C_FOOTER = {
+	"\treturn 0;\n"\
+	"}\n"
+};
+
+static void write_c_move(std::ostream& os, std::string const& indent, int const& arg) {
+	if (arg > 0) os << indent << "i += " << arg << ";\n" << indent << "if (i >= size) reserve(i);\n";
+	else {
+		//There is no cell before the first one
+		os << indent << "if (i < " << -arg << ") out_of_tape((long)i - " << -arg << ");\n";
+		os << indent << "i -= " << -arg << ";\n";
+	}
+}
+
+//Make the cell at offset of the pointer exist
+static void write_c_reserve(std::ostream& os, std::string const& indent, int const& offset) {
+	if (offset < 0) os << indent << "if (i < " << -offset << ") out_of_tape((long)i - " << -offset << ");\n";
+	else if (offset > 0) os << indent << "if (i + " << offset << " >= size) reserve(i + " << offset << ");\n";
+}
+
+static std::string c_cell(int const& offset) {
+	if (offset == 0) return "tape[i]";
+	return "tape[i " + std::string(offset < 0 ? "- " : "+ ") + std::to_string(std::abs(offset)) + "]";
+}
+
+void translate_to_c(std::ostream& os, BFProgram const& program, unsigned int const& cell_bits) {
+	if (cell_bits != 8 && cell_bits != 16 && cell_bits != 32)
+		throw std::invalid_argument("The cells can only be 8, 16 or 32 bits wide\n");
+	os << C_INCLUDES << "typedef uint" << cell_bits << "_t cell;\n\n" << C_HEADER;
+	std::string indent("\t");
+	for (Instruction const& action : program.instructions()) {
+		switch (action.op) {
+		case OpCode::ADD:
+			write_c_reserve(os, indent, action.offset);
+			os << indent << c_cell(action.offset) << " += " << action.arg << ";\n";
+			break;
+		case OpCode::MOVE:
+			write_c_move(os, indent, action.arg);
+			break;
+		case OpCode::OPEN:
+			os << indent << "while (tape[i]) {\n";
+			indent += '\t';
+			break;
+		case OpCode::CLOSE:
+			indent.pop_back();
+			os << indent << "}\n";
+			break;
+		case OpCode::INPUT:
+			write_c_reserve(os, indent, action.offset);
+			os << indent << "if ((c = getchar()) != EOF) " << c_cell(action.offset) << " = (unsigned char)c;\n";
+			break;
+		case OpCode::OUTPUT:
+			write_c_reserve(os, indent, action.offset);
+			os << indent << "putchar((unsigned char)" << c_cell(action.offset) << ");\n";
+			break;
+		case OpCode::CLEAR:
+			write_c_reserve(os, indent, action.offset);
+			os << indent << c_cell(action.offset) << " = 0;\n";
+			break;
+		case OpCode::SCAN:
+			os << indent << "while (tape[i]) {\n";
+			write_c_move(os, indent + '\t', action.arg);
+			os << indent << "}\n";
+			break;
+		case OpCode::MUL:
+			os << indent << "if (tape[i]) {\n";
+			write_c_reserve(os, indent + '\t', action.offset);
+			os << indent << "\ttape[i + " << action.offset << "] += tape[i] * " << action.arg << "u;\n";
+			os << indent << "}\n";
+			break;
+		case OpCode::RESERVE:
+			//The translated code checks every move, the compiler of the language removes what it can
+			break;
+		}
+	}
+	os << C_FOOTER;
+}
+
+//---ASSEMBLY TRANSLATION---
+
+//The pointer is kept in %rbx and the tape is [%r12, %r13), the helpers
+//grow the tape with realloc when the pointer goes past its end
+const std::string ASSEMBLY_HEADER = {
+	"# Generated by BF from brainfuck code\n"\
+	"\t.text\n"\
+	"\n"\
+	"# Grow the tape so that the cell at index %rdi exists, keep the pointer index\n"\
+	"bf_grow:\n"\
+	"\tpushq %rbp\n"\
+	"\tmovq %rbx, %rbp\n"\
+	"\tsubq %r12, %rbp\n"\
+	"\tleaq 1(%rdi), %rsi\n"\
+	"\tmovq %r13, %r15\n"\
+	"\tsubq %r12, %r15\n"\
+	"\tleaq (%r15,%r15), %r14\n"\
+	"\tcmpq %rsi, %r14\n"\
+	"\tcmovbq %rsi, %r14\n"\
+	"\tmovq %r12, %rdi\n"\
+	"\tmovq %r14, %rsi\n"\
+	"\tcall realloc@PLT\n"\
+	"\ttestq %rax, %rax\n"\
+	"\tjz bf_no_memory\n"\
+	"\tmovq %rax, %r12\n"\
+	"\tleaq (%rax,%r15), %rdi\n"\
+	"\txorl %esi, %esi\n"\
+	"\tmovq %r14, %rdx\n"\
+	"\tsubq %r15, %rdx\n"\
+	"\tcall memset@PLT\n"\
+	"\tleaq (%r12,%r14), %r13\n"\
+	"\tleaq (%r12,%rbp), %rbx\n"\
+	"\tpopq %rbp\n"\
+	"\tret\n"\
+	"\n"\
+	"# Called when %rbx left the tape after a move\n"\
+	"bf_move:\n"\
+	"\tcmpq %r12, %rbx\n"\
+	"\tjb bf_out_of_tape\n"\
+	"\tmovq %rbx, %rdi\n"\
+	"\tsubq %r12, %rdi\n"\
+	"\tjmp bf_grow\n"\
+	"\n"\
+	"bf_no_memory:\n"\
+	"\tleaq bf_no_memory_message(%rip), %rdi\n"\
+	"\tjmp bf_fail\n"\
+	"bf_out_of_tape:\n"\
+	"\tleaq bf_out_of_tape_message(%rip), %rdi\n"\
+	"bf_fail:\n"\
+	"\tandq $-16, %rsp\n"\
+	"\tcall puts@PLT\n"\
+	"\tmovl $1, %edi\n"\
+	"\tcall exit@PLT\n"\
+	"\n"\
+	"\t.globl main\n"\
+	"\t.type main, @function\n"\
+	"main:\n"\
+	"\tpushq %rbx\n"\
+	"\tpushq %r12\n"\
+	"\tpushq %r13\n"\
+	"\tpushq %r14\n"\
+	"\tpushq %r15\n"\
+	"\tmovl $1, %edi\n"\
+	"\tmovl $1, %esi\n"\
+	"\tcall calloc@PLT\n"\
+	"\ttestq %rax, %rax\n"\
+	"\tjz bf_no_memory\n"\
+	"\tmovq %rax, %r12\n"\
+	"\tmovq %rax, %rbx\n"\
+	"\tleaq 1(%rax), %r13\n"
+};
+
+const std::string ASSEMBLY_FOOTER = {
+	"\txorl %eax, %eax\n"\
+	"\tpopq %r15\n"\
+	"\tpopq %r14\n"\
+	"\tpopq %r13\n"\
+	"\tpopq %r12\n"\
+	"\tpopq %rbx\n"\
+	"\tret\n"\
+	"\t.size main, .-main\n"\
+	"\n"\
+	"\t.section .rodata\n"\
+	"bf_no_memory_message:\n"\
+	"\t.string \"Unable to grow the tape\"\n"\
+	"bf_out_of_tape_message:\n"\
+	"\t.string \"A cell out of the tape has been used\"\n"\
+	"\t.section .note.GNU-stack,\"\",@progbits\n"
+};
+
+static void write_assembly_move(std::ostream& os, int const& arg, size_t const& label) {
+	os << "\taddq $" << arg << ", %rbx\n";
+	if (arg > 0) os << "\tcmpq %r13, %rbx\n\tjb .Lin" << label << "\n";
+	else os << "\tcmpq %r12, %rbx\n\tjae .Lin" << label << "\n";
+	os << "\tcall bf_move\n.Lin" << label << ":\n";
+}
+
+//Make the cell at offset of %rbx exist, the labels are named after the given name
+static void write_assembly_reserve(std::ostream& os, int const& offset, std::string const& label) {
+	if (offset == 0) return;
+	os << "\tleaq " << offset << "(%rbx), %rcx\n";
+	os << "\tcmpq %r13, %rcx\n\tjae .Lout" << label << "\n";
+	os << "\tcmpq %r12, %rcx\n\tjae .Lin" << label << "\n";
+	os << ".Lout" << label << ":\n";
+	os << "\tcmpq %r12, %rcx\n\tjb bf_out_of_tape\n";
+	os << "\tmovq %rcx, %rdi\n\tsubq %r12, %rdi\n\tcall bf_grow\n";
+	os << ".Lin" << label << ":\n";
+}
+
+void translate_to_assembly(std::ostream& os, BFProgram const& program) {
+	os << ASSEMBLY_HEADER;
+	std::vector<Instruction> const& code = program.instructions();
+	//Labels are named after the index of their instruction
+	for (size_t i(0); i != code.size(); ++i) {
+		Instruction const& action = code[i];
+		switch (action.op) {
+		case OpCode::ADD:
+			write_assembly_reserve(os, action.offset, "r" + std::to_string(i));
+			os << "\taddb $" << (action.arg & 0xff) << ", " << action.offset << "(%rbx)\n";
+			break;
+		case OpCode::MOVE:
+			write_assembly_move(os, action.arg, i);
+			break;
+		case OpCode::OPEN:
+			os << "\tcmpb $0, (%rbx)\n\tje .Lend" << i << "\n.Lbody" << i << ":\n";
+			break;
+		case OpCode::CLOSE:
+			os << "\tcmpb $0, (%rbx)\n\tjne .Lbody" << action.arg << "\n.Lend" << action.arg << ":\n";
+			break;
+		case OpCode::INPUT:
+			write_assembly_reserve(os, action.offset, "r" + std::to_string(i));
+			os << "\tcall getchar@PLT\n\tcmpl $-1, %eax\n\tje .Lin" << i << "\n";
+			os << "\tmovb %al, " << action.offset << "(%rbx)\n.Lin" << i << ":\n";
+			break;
+		case OpCode::OUTPUT:
+			write_assembly_reserve(os, action.offset, "r" + std::to_string(i));
+			os << "\tmovzbl " << action.offset << "(%rbx), %edi\n\tcall putchar@PLT\n";
+			break;
+		case OpCode::CLEAR:
+			write_assembly_reserve(os, action.offset, "r" + std::to_string(i));
+			os << "\tmovb $0, " << action.offset << "(%rbx)\n";
+			break;
+		case OpCode::SCAN:
+			os << ".Lscan" << i << ":\n\tcmpb $0, (%rbx)\n\tje .Lend" << i << "\n";
+			write_assembly_move(os, action.arg, i);
+			os << "\tjmp .Lscan" << i << "\n.Lend" << i << ":\n";
+			break;
+		case OpCode::MUL:
+			os << "\tcmpb $0, (%rbx)\n\tje .Lend" << i << "\n";
+			write_assembly_reserve(os, action.offset, std::to_string(i));
+			os << "\tmovzbl (%rbx), %eax\n\timull $" << action.arg << ", %eax, %eax\n";
+			os << "\taddb %al, " << action.offset << "(%rbx)\n";
+			os << ".Lend" << i << ":\n";
+			break;
+		case OpCode::RESERVE:
+			//The moves are checked as they are written
+			break;
+		}
+	}
+	os << ASSEMBLY_FOOTER;
+}
+
+void translate_to_file(std::string const& path, BFProgram const& program, unsigned int const& cell_bits) {
+	std::string::size_type dot = path.rfind('.');
+	bool assembly = dot != std::string::npos && (path.substr(dot) == ".s" || path.substr(dot) == ".S");
+	if (assembly && cell_bits != 8) throw std::invalid_argument("The assembly translation only has 8 bits cells\n");
+	std::ofstream f(path);
+	if (f.fail()) throw std::invalid_argument("Unable to open the output file\n");
+	if (assembly) translate_to_assembly(f, program);
+	else translate_to_c(f, program, cell_bits);
+	if (f.fail()) throw std::runtime_error("An error occured when writing the output file\n");
+}